@@ -0,0 +1,174 @@
+#include "DayHistory.h"
+
+// Bytes a varint takes for a value of the given number of bits
+#define VARINT_BYTES(bits) (((bits) + 6) / 7)
+// Worst case size of one compacted day: flags, the coin change as a
+// 32 bit varint, then all four bitmasks (events, planted, harvested and
+// wiped) as 16 bit varints
+#define MAX_DAY_BYTES (1 + VARINT_BYTES(32) + 4 * VARINT_BYTES(8 * sizeof(uint16_t)))
+
+// Flags byte, one bit per bitmask that follows
+#define HAS_EVENTS 1
+#define HAS_PLANTED 2
+#define HAS_HARVESTED 4
+#define HAS_WIPED 8
+
+// Small coin changes either way become small unsigned numbers
+static inline uint32_t zigzag(int value) {
+    return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+static inline int unzigzag(uint32_t value) {
+    return (int) (value >> 1) ^ -(int) (value & 1);
+}
+
+DayHistory::DayHistory() {
+    clear();
+}
+
+void DayHistory::clear() {
+    recent_head = 0;
+    recent_count = 0;
+    block_head = 0;
+    block_count = 0;
+    block_days = 0;
+    write_pos = 0;
+}
+
+int DayHistory::size() {
+    return recent_count + block_days;
+}
+
+int DayHistory::first_day() {
+    if (block_count) return blocks[block_head].first_day;
+    if (recent_count) return recent[recent_head].day;
+    return 0;
+}
+
+// Adds the next day, pushing the oldest recent day into the blocks once
+// the ring is full
+void DayHistory::append(const day_record& record) {
+    if (recent_count < HISTORY_RECENT_DAYS) {
+        recent[(recent_head + recent_count) % HISTORY_RECENT_DAYS] = record;
+        recent_count++;
+        return;
+    }
+    compact(recent[recent_head]);
+    recent[recent_head] = record;
+    recent_head = (recent_head + 1) % HISTORY_RECENT_DAYS;
+}
+
+// Encodes one day onto the end of the newest block
+void DayHistory::compact(const day_record& record) {
+    // a new block is started when the newest one is full, and also if the
+    // day doesn't follow on from it (days and coins are rebuilt from the
+    // start of the block, so they have to line up)
+    history_block* newest = block_count ? &blocks[(block_head + block_count - 1) % HISTORY_MAX_BLOCKS] : nullptr;
+    if (!newest || newest->days == HISTORY_BLOCK_DAYS ||
+        record.day != newest->first_day + newest->days ||
+        record.coins - record.coins_delta != newest->end_coins) {
+        if (block_count == HISTORY_MAX_BLOCKS) drop_oldest_block();
+        newest = &blocks[(block_head + block_count) % HISTORY_MAX_BLOCKS];
+        newest->first_day = record.day;
+        newest->start_coins = record.coins - record.coins_delta;
+        newest->start = write_pos;
+        newest->days = 0;
+        block_count++;
+    }
+
+    // make room, oldest blocks first (the newest block can't be dropped,
+    // it's never anywhere near HISTORY_BYTES long)
+    while (write_pos + MAX_DAY_BYTES - blocks[block_head].start > HISTORY_BYTES) {
+        drop_oldest_block();
+    }
+
+    uint8_t flags = (record.events ? HAS_EVENTS : 0) | (record.planted ? HAS_PLANTED : 0) |
+                    (record.harvested ? HAS_HARVESTED : 0) | (record.wiped ? HAS_WIPED : 0);
+    put_byte(flags);
+    put_varint(zigzag(record.coins_delta));
+    if (record.events) put_varint(record.events);
+    if (record.planted) put_varint(record.planted);
+    if (record.harvested) put_varint(record.harvested);
+    if (record.wiped) put_varint(record.wiped);
+
+    newest->days++;
+    newest->end_coins = record.coins;
+    block_days++;
+}
+
+void DayHistory::drop_oldest_block() {
+    block_days -= blocks[block_head].days;
+    block_head = (block_head + 1) % HISTORY_MAX_BLOCKS;
+    block_count--;
+}
+
+void DayHistory::put_byte(uint8_t value) {
+    bytes[write_pos % HISTORY_BYTES] = value;
+    write_pos++;
+}
+
+// Seven bits at a time, low bits first, high bit set on all but the last
+void DayHistory::put_varint(uint32_t value) {
+    while (value >= 0x80) {
+        put_byte((uint8_t) (value | 0x80));
+        value >>= 7;
+    }
+    put_byte((uint8_t) value);
+}
+
+// Decodes a block into out, leaving out the first skip days, and returns
+// how many days were written
+int DayHistory::decode_block(const history_block& block, int skip, day_record* out) {
+    long long pos = block.start;
+    int coins = block.start_coins;
+    int written = 0;
+    for (int i = 0; i < block.days; i++) {
+        uint32_t fields[5] = {0, 0, 0, 0, 0};
+        uint8_t flags = bytes[pos++ % HISTORY_BYTES];
+        // coin change always follows, the bitmasks only if flagged
+        for (int f = 0; f < 5; f++) {
+            if (f > 0 && !(flags & (1 << (f - 1)))) continue;
+            uint32_t value = 0;
+            int shift = 0;
+            uint8_t b;
+            do {
+                b = bytes[pos++ % HISTORY_BYTES];
+                value |= (uint32_t) (b & 0x7f) << shift;
+                shift += 7;
+            } while (b & 0x80);
+            fields[f] = value;
+        }
+        int delta = unzigzag(fields[0]);
+        coins += delta;
+        if (i < skip) continue;
+        out[written++] = day_record{block.first_day + i, coins, delta, (uint16_t) fields[1],
+                                    (uint16_t) fields[2], (uint16_t) fields[3], (uint16_t) fields[4]};
+    }
+    return written;
+}
+
+int DayHistory::last_days(day_record* out, int n) {
+    if (n > size()) n = size();
+    if (n <= 0) return 0;
+    int from_recent = n < recent_count ? n : recent_count;
+    int from_blocks = n - from_recent;
+    int written = 0;
+
+    if (from_blocks > 0) {
+        // walk back from the newest block to the oldest one still needed,
+        // then decode forwards, skipping whatever's older than asked for
+        int b = block_count, held = 0;
+        while (held < from_blocks) {
+            b--;
+            held += blocks[(block_head + b) % HISTORY_MAX_BLOCKS].days;
+        }
+        int skip = held - from_blocks;
+        for (; b < block_count; b++) {
+            written += decode_block(blocks[(block_head + b) % HISTORY_MAX_BLOCKS], skip, out + written);
+            skip = 0;
+        }
+    }
+    for (int i = recent_count - from_recent; i < recent_count; i++) {
+        out[written++] = recent[(recent_head + i) % HISTORY_RECENT_DAYS];
+    }
+    return written;
+}
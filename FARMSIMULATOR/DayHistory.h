@@ -0,0 +1,87 @@
+#ifndef DAYHISTORY_H
+#define DAYHISTORY_H
+
+#include <cstdint>
+
+// Limits for the day history
+// Most recent days kept as plain records
+#define HISTORY_RECENT_DAYS 64
+// Days per compacted block, and bytes shared by all the blocks
+#define HISTORY_BLOCK_DAYS 32
+#define HISTORY_BYTES 4096
+// Every compacted day takes at least two bytes, so this many blocks can
+// never all fit in HISTORY_BYTES (plus one being filled)
+#define HISTORY_MAX_BLOCKS (HISTORY_BYTES / (2 * HISTORY_BLOCK_DAYS) + 2)
+// Plots tracked in the plot bitmasks, enough for the ones shown on screen
+#define HISTORY_PLOT_BITS 16
+
+// What happened on one day
+// The bitmasks have bit i set for events[i] in GameState, and for plot i
+// (only the first HISTORY_PLOT_BITS plots are tracked).
+struct day_record_raw {
+    int day;
+    int coins; // at the end of the day
+    int coins_delta; // change over the day, events included
+    uint16_t events;
+    uint16_t planted;
+    uint16_t harvested;
+    uint16_t wiped;
+} typedef day_record;
+
+// Day by day record of a game, in a fixed amount of memory
+// The last HISTORY_RECENT_DAYS days are kept as plain records in a ring.
+// As each one falls out of the ring it's compacted onto the end of a
+// block: a flags byte saying which bitmasks aren't empty, the coin change
+// as a zigzag varint, then each non-empty bitmask as a varint, so a quiet
+// day takes two or three bytes instead of twenty. Day numbers and coin
+// balances aren't stored per day at all, they're rebuilt from the start
+// of the block. Blocks share a ring of HISTORY_BYTES bytes, and the oldest
+// block is dropped whenever a new day needs its space.
+//
+// append is O(1) and never allocates. Reading decodes at most one partial
+// block beyond the days asked for.
+class DayHistory {
+    public:
+        DayHistory();
+
+        void clear();
+        void append(const day_record& record);
+
+        // days still held, and the first of them
+        int size();
+        int first_day();
+
+        // copies the last n days held (or all of them, if fewer) into out,
+        // oldest first, and returns how many were copied
+        int last_days(day_record* out, int n);
+
+    private:
+        // recent ring, recent_head is the oldest
+        day_record recent[HISTORY_RECENT_DAYS];
+        int recent_head, recent_count;
+
+        struct history_block {
+            int first_day;
+            int start_coins; // balance before the first day
+            long long start; // position of the first byte, see write_pos
+            int days;
+            int end_coins; // balance after the last day
+        };
+        // block ring, block_head is the oldest and the newest is the one
+        // being filled
+        history_block blocks[HISTORY_MAX_BLOCKS];
+        int block_head, block_count;
+        int block_days; // days held in all the blocks
+
+        // byte ring, positions count up forever and wrap when used
+        uint8_t bytes[HISTORY_BYTES];
+        long long write_pos;
+
+        void compact(const day_record& record);
+        void drop_oldest_block();
+        void put_byte(uint8_t value);
+        void put_varint(uint32_t value);
+        int decode_block(const history_block& block, int skip, day_record* out);
+};
+
+#endif // DAYHISTORY_H
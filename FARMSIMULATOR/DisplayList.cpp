@@ -0,0 +1,226 @@
+#include "DisplayList.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cstring>
+
+/*
+Member functions for DisplayList
+Created 10/19/2026
+*/
+void DisplayList::build(UIElement* root) {
+    root->cullDrawList(nodes);
+    commands.clear();
+
+    // same walk as UIElement::renderVisible, recording instead of drawing
+    int count = (int) nodes.size();
+    int i = 0;
+    while (i < count) {
+        const DrawNode& node = nodes[i];
+        int after = node.end < count ? nodes[node.end].visibleFrom : 0;
+        if (node.visibleFrom == after) {
+            i = node.end;
+            continue;
+        }
+        if (node.visible) {
+            if (node.item) addItem(*node.item, node.label);
+            else addElement(node.element);
+        }
+        ++i;
+    }
+}
+
+void DisplayList::addElement(UIElement* element) {
+    switch (element->elementType) {
+    case ELEMENT_RECTANGLE: {
+        RectangleElement* e = static_cast<RectangleElement*>(element);
+        add(DRAW_RECT, e->xPos, e->yPos, e->width, e->height, e->fillColor, e->lineColor, nullptr, 0);
+        break;
+    }
+    case ELEMENT_CIRCLE: {
+        CircleElement* e = static_cast<CircleElement*>(element);
+        add(DRAW_CIRCLE, e->xPos, e->yPos, e->radius, e->radius, e->fillColor, e->lineColor, nullptr, 0);
+        break;
+    }
+    case ELEMENT_STRING: {
+        StringElement* e = static_cast<StringElement*>(element);
+        add(DRAW_TEXT, e->xPos, e->yPos, 0, 0, e->fontColor, e->fontColor, e->textString, 0);
+        break;
+    }
+    case ELEMENT_VALUE: {
+        ValueElement* e = static_cast<ValueElement*>(element);
+        add(DRAW_VALUE, e->xPos, e->yPos, 0, 0, e->fontColor, e->fontColor, nullptr, e->valueFunction());
+        break;
+    }
+    default:
+        // unknown element type, let it draw itself
+        add(DRAW_CUSTOM, 0, 0, 0, 0, 0, 0, nullptr, 0);
+        commands.back().element = element;
+        break;
+    }
+}
+
+void DisplayList::addItem(const StaticItem& item, bool label) {
+    if (label) {
+        add(DRAW_TEXT, item.x + item.padding, item.y + item.padding, 0, 0, item.textColor, item.textColor,
+            item.text, 0);
+        return;
+    }
+    switch (item.kind) {
+    case STATIC_RECT:
+        add(DRAW_RECT, item.x, item.y, item.w, item.h, item.fill, item.line, nullptr, 0);
+        break;
+    case STATIC_CIRCLE:
+        add(DRAW_CIRCLE, item.x, item.y, item.w, item.w, item.fill, item.line, nullptr, 0);
+        break;
+    case STATIC_TEXT:
+        add(DRAW_TEXT, item.x, item.y, 0, 0, item.textColor, item.textColor, item.text, 0);
+        break;
+    }
+}
+
+void DisplayList::add(int kind, int x, int y, int w, int h, unsigned int fill, unsigned int line, stringT text, int value) {
+    DrawCommand c;
+    c.kind = kind;
+    c.x = x;
+    c.y = y;
+    c.w = w;
+    c.h = h;
+    c.fill = fill;
+    c.line = line;
+    c.text = text;
+    c.value = value;
+    c.element = nullptr;
+    c.layer = 0;
+
+    // area touched, and the batching key: shapes and text share the one
+    // foreground color, so text sorts in with shapes filled the same color
+    switch (kind) {
+    case DRAW_RECT:
+        // nothing gets drawn for an empty rectangle
+        if (w <= 0 || h <= 0) return;
+        c.box[0] = x; c.box[1] = y; c.box[2] = x + w; c.box[3] = y + h;
+        c.key = ((uint64_t) fill << 24) | line;
+        break;
+    case DRAW_CIRCLE:
+        c.box[0] = x - w; c.box[1] = y - w; c.box[2] = x + w + 1; c.box[3] = y + w + 1;
+        c.key = ((uint64_t) fill << 24) | line;
+        break;
+    case DRAW_TEXT:
+    case DRAW_VALUE: {
+        int length;
+        if (kind == DRAW_TEXT) {
+            length = (int) strlen(text);
+        }
+        else {
+            // count digits rather than formatting the number
+            length = value < 0 ? 2 : 1;
+            for (long long v = value < 0 ? -(long long) value : value; v >= 10; v /= 10) ++length;
+        }
+        if (!length) return;
+        c.box[0] = x; c.box[1] = y; c.box[2] = x + length * CHAR_WIDTH; c.box[3] = y + CHAR_HEIGHT;
+        c.key = ((uint64_t) fill << 24) | fill;
+        break;
+    }
+    default:
+        // could draw anywhere in any color, so it overlaps everything
+        c.box[0] = 0; c.box[1] = 0; c.box[2] = SCREEN_WIDTH; c.box[3] = SCREEN_HEIGHT;
+        c.key = 2ull << 56;
+        break;
+    }
+    commands.push_back(c);
+}
+
+void DisplayList::batch() {
+    // layer of each command is one more than the highest layer of any
+    // earlier command it overlaps
+    int count = (int) commands.size();
+    for (int i = 0; i < count; ++i) {
+        DrawCommand& c = commands[i];
+        int layer = 0;
+        for (int j = 0; j < i; ++j) {
+            const DrawCommand& prev = commands[j];
+            if (prev.layer >= layer && prev.box[0] < c.box[2] && c.box[0] < prev.box[2]
+                                    && prev.box[1] < c.box[3] && c.box[1] < prev.box[3]) {
+                layer = prev.layer + 1;
+            }
+        }
+        c.layer = layer;
+    }
+
+    // draw layer by layer, grouped by color within a layer
+    order.resize(count);
+    for (int i = 0; i < count; ++i) order[i] = i;
+    const std::vector<DrawCommand>& list = commands;
+    std::stable_sort(order.begin(), order.end(), [&list](int a, int b) {
+        if (list[a].layer != list[b].layer) return list[a].layer < list[b].layer;
+        return list[a].key < list[b].key;
+    });
+}
+
+int DisplayList::execute() {
+    // foreground color currently set on the LCD, unknown until the first
+    // change; shapes and text share it, so a fill changes the text color too
+    unsigned int foreground = 0;
+    bool known = false;
+    int changes = 0;
+
+    int count = (int) commands.size();
+    if ((int) order.size() != count) {
+        // batch wasn't called, draw in tree order
+        order.resize(count);
+        for (int i = 0; i < count; ++i) order[i] = i;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const DrawCommand& c = commands[order[i]];
+        switch (c.kind) {
+        case DRAW_RECT:
+        case DRAW_CIRCLE:
+            // fill, then the border if it's a different color
+            if (!known || foreground != c.fill) {
+                LCD.SetDrawColor((colorT) c.fill);
+                foreground = c.fill;
+                known = true;
+                ++changes;
+            }
+            if (c.kind == DRAW_RECT) LCD.FillRectangle(c.x, c.y, c.w, c.h);
+            else LCD.FillCircle(c.x, c.y, c.w);
+            if (c.fill != c.line) {
+                LCD.SetDrawColor((colorT) c.line);
+                foreground = c.line;
+                ++changes;
+                if (c.kind == DRAW_RECT) LCD.DrawRectangle(c.x, c.y, c.w, c.h);
+                else LCD.DrawCircle(c.x, c.y, c.w);
+            }
+            break;
+        case DRAW_TEXT:
+        case DRAW_VALUE:
+            if (!known || foreground != c.fill) {
+                LCD.SetFontColor((colorT) c.fill);
+                foreground = c.fill;
+                known = true;
+                ++changes;
+            }
+            if (c.kind == DRAW_TEXT) LCD.WriteAt(c.text, c.x, c.y);
+            else LCD.WriteAt(c.value, c.x, c.y);
+            break;
+        default:
+            // element sets its own colors
+            c.element->renderSelf();
+            known = false;
+            break;
+        }
+    }
+    order.clear();
+    return changes;
+}
+
+int DisplayList::render(UIElement* root) {
+    PERF_REGION(perf, "DisplayList::render");
+    build(root);
+    PERF_ITEMS(perf, (long long) commands.size());
+    batch();
+    return execute();
+}
+
+int DisplayList::size() { return (int) commands.size(); }
@@ -0,0 +1,86 @@
+#ifndef DisplayList_H
+#define DisplayList_H
+
+#include "UIEngine.h"
+#include <cstdint>
+#include <vector>
+
+/*
+DisplayList class
+Created 10/19/2026
+
+Renders an element tree as a flat list of draw commands instead of calling
+renderSelf on every element. Each frame goes through three steps:
+
+void DisplayList::build(UIElement* root)
+Runs the occlusion pass from UIElement::cullDrawList and turns every visible
+element into a DrawCommand, a plain tagged struct holding what the LCD calls
+need (kind, geometry, colors, text or value). Element members are read
+directly using the element's elementType tag, so there are no virtual calls
+per element. The occlusion pass already lists a static page's items one by
+one, so each visible item (or rectangle label) becomes a command of its own.
+Element types the list doesn't know about (sprites, or anything derived from
+UIElement elsewhere) become a CUSTOM command that just calls renderSelf.
+
+void DisplayList::batch()
+Reorders commands to cut down on color changes. Every command is given a
+layer one above the highest layer of any earlier command it overlaps, so
+commands in the same layer never overlap each other and can be drawn in any
+order. Layers are drawn in order, and within a layer commands are grouped by
+color, text next to shapes filled the same color. Any two commands that do overlap
+keep their original order, so the frame comes out the same.
+
+int DisplayList::execute()
+Draws the commands, only calling SetDrawColor/SetFontColor when the color
+actually changes. The LCD has a single foreground color for shapes and text,
+so text drawn after a fill in another color sets its color again. Returns the
+number of color changes sent to the LCD.
+
+int DisplayList::render(UIElement* root)
+All three in a row, which is what the main loop calls. Returns the number of
+color changes.
+
+A DisplayList keeps its buffers between frames, so keep one around (one per
+thread when rendering sessions in parallel) instead of making a new one each
+frame.
+*/
+#define DRAW_RECT 0
+#define DRAW_CIRCLE 1
+#define DRAW_TEXT 2
+#define DRAW_VALUE 3
+#define DRAW_CUSTOM 4
+
+struct DrawCommand {
+    int kind;
+    int x, y, w, h; // circles use x and y as the center and w as the radius
+    unsigned int fill, line; // text uses fill as the font color
+    stringT text;
+    int value;
+    UIElement* element; // CUSTOM only
+    int box[4]; // screen area touched: left, top, right, bottom (exclusive)
+    int layer;
+    uint64_t key; // batching order within a layer
+};
+
+class DisplayList {
+    public:
+    void build(UIElement* root);
+    void batch();
+    int execute();
+    int render(UIElement* root);
+
+    int size();
+
+    private:
+    // append commands for one element, or for one static page item (or
+    // its label)
+    void addElement(UIElement* element);
+    void addItem(const StaticItem& item, bool label);
+    void add(int kind, int x, int y, int w, int h, unsigned int fill, unsigned int line, stringT text, int value);
+
+    std::vector<DrawNode> nodes;
+    std::vector<DrawCommand> commands;
+    std::vector<int> order;
+};
+
+#endif // DisplayList_H
@@ -0,0 +1,76 @@
+#include "EventTable.h"
+#include "FEHRandom.h"
+
+// RandInt returns values in [0, RAND_RANGE)
+#define RAND_RANGE 32768
+
+EventTable::EventTable() {
+    // a single event that always happens until weights are set
+    count = 1;
+    accept_limit = RAND_RANGE;
+    keep[0] = RAND_RANGE;
+    alias[0] = 0;
+}
+
+int EventTable::size() {
+    return count;
+}
+
+// Standard alias table construction (Vose's variant): scale the weights so
+// they average to 1, then repeatedly pair an under-full column with an
+// over-full one, topping the former up from the latter.
+void EventTable::set_weights(const int* weights, int n) {
+    if (n < 1) n = 1;
+    if (n > MAX_EVENT_TYPES) n = MAX_EVENT_TYPES;
+    count = n;
+    accept_limit = RAND_RANGE - RAND_RANGE % n;
+    const long long scale = accept_limit / n;
+
+    long long total = 0;
+    for (int i = 0; i < n; i++) {
+        total += weights[i] > 0 ? weights[i] : 0;
+    }
+    if (total == 0) total = 1;
+
+    // scaled[i] = weight * n, compared against total in integer arithmetic
+    long long scaled[MAX_EVENT_TYPES];
+    int small[MAX_EVENT_TYPES], large[MAX_EVENT_TYPES];
+    int numSmall = 0, numLarge = 0;
+    for (int i = 0; i < n; i++) {
+        scaled[i] = (long long) (weights[i] > 0 ? weights[i] : 0) * n;
+        alias[i] = (uint8_t) i;
+        if (scaled[i] < total) small[numSmall++] = i;
+        else large[numLarge++] = i;
+    }
+    while (numSmall && numLarge) {
+        int s = small[--numSmall];
+        int l = large[numLarge - 1];
+        keep[s] = (uint32_t) (scaled[s] * scale / total);
+        alias[s] = (uint8_t) l;
+        scaled[l] -= total - scaled[s];
+        if (scaled[l] < total) {
+            --numLarge;
+            small[numSmall++] = l;
+        }
+    }
+    // whatever is left is full up to rounding error
+    while (numLarge) keep[large[--numLarge]] = (uint32_t) scale;
+    while (numSmall) keep[small[--numSmall]] = (uint32_t) scale;
+}
+
+int EventTable::draw() {
+    int r;
+    do {
+        r = RandInt();
+    } while (r >= accept_limit);
+    // r % count is the column and r / count is uniform over the coin range,
+    // independently of each other
+    int column = r % count;
+    return (uint32_t) (r / count) < keep[column] ? column : alias[column];
+}
+
+void EventTable::draw_many(int* out, int k) {
+    for (int i = 0; i < k; i++) {
+        out[i] = draw();
+    }
+}
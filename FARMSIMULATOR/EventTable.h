@@ -0,0 +1,39 @@
+#ifndef EVENTTABLE_H
+#define EVENTTABLE_H
+
+#include <cstdint>
+
+// Most event types a table can hold
+#define MAX_EVENT_TYPES 16
+
+// Weighted random choice between event types using Walker's alias method.
+// Building the table from a list of integer weights is O(n) and only needs
+// to happen when the weights change; each draw after that is O(1): pick a
+// column uniformly, then either keep it or take its alias depending on a
+// biased coin. Both come out of a single RandInt call most of the time,
+// and the column is picked by rejection so there's no modulo bias.
+class EventTable {
+    public:
+        EventTable();
+
+        // Rebuilds the table, weights[i] is the relative chance of event i
+        // (zero means never). At least one weight must be positive.
+        void set_weights(const int* weights, int n);
+
+        // Draws one event index, or k of them into out
+        int draw();
+        void draw_many(int* out, int k);
+
+        int size();
+
+    private:
+        int count;
+        // draws of RandInt below this are accepted, the rest are retried
+        int accept_limit;
+        // keep column i with chance keep[i] / (accept_limit / count),
+        // otherwise take alias[i]
+        uint32_t keep[MAX_EVENT_TYPES];
+        uint8_t alias[MAX_EVENT_TYPES];
+};
+
+#endif // EVENTTABLE_H
@@ -6,18 +6,21 @@
 
 #include "GameState.h"
 #include "FEHRandom.h"
+#include "PerfCounters.h"
 
 // Inital constants and setup by Drew
 #define NUMBER_OF_PLOTS 12
-#define START_COINS 500
+// Initial timing wheel size, must be a power of two larger than the
+// longest grow time (lettuce, 5 days); grown on demand for longer crops
+#define WHEEL_SIZE 8
+#define READY_SLOT (-2)
 //All "chaos mode" additions made by Annie
-#define CHAOS_START_COINS 400
 
 // Written by Drew
 // Simple text function that returns "Hello, World"
 // as a C string. Used to test calling GameState functions
 // from the UI
-char* GameState::test() {
+const char* GameState::test() {
    return "Hello, World!";
 }
 
@@ -25,26 +28,39 @@ char* GameState::test() {
 // Constructor
 // Sets of the plots to empty, the events to inactive
 // and resets the local game stats.
-GameState::GameState(int diff){
+// numPlots defaults to the 12 plots shown in the UI, and config to the
+// game's usual balance.
+GameState::GameState(int diff, int numPlots, const game_config& config){
 
     // Initialize state variables
     difficulty = diff;
-    coins = START_COINS;
+    coins = config.start_coins;
+    for (int i = 0; i < 10; i++) {
+       events[i].moneyAmount = config.event_amounts[i];
+    }
     curr_day = 1;
     total_stats = stats{0, 0, 0, 0};
 
+    //Build the weighted event tables for the difficulty
+    for (int i = 0; i < NUMBER_OF_SEASONS; i++) {
+       set_event_weights(i, difficulty == 1 ? chaos_event_weights[i] : normal_event_weights[i]);
+    }
+    events_per_day = 1;
+
     //Check if player selected chaos mode
     if (difficulty == 1) {
+       //Two events happen each day
+       events_per_day = 2;
        //Initialize chaos starting coin amount
-       coins = CHAOS_START_COINS;
+       coins = config.chaos_start_coins;
        //Loop through all of the possible events
        for (int i = 0; i < 10; i++) {
           //If the event is bad, double the monetary damage of it
           if (events[i].isPenalty) {
-             events[i].moneyAmount *= 2;
+             events[i].moneyAmount *= config.chaos_penalty_multiplier;
           //If the event is good, halve the monetary benefit of it
           } else {
-             events[i].moneyAmount /= 2;
+             events[i].moneyAmount /= config.chaos_bonus_divisor;
           }
        }
     }
@@ -55,24 +71,146 @@ GameState::GameState(int diff){
        event_occurred[i] = false;
     }
 
-    // Set all of the plots to an empty
-    for(int i = 0; i < NUMBER_OF_PLOTS; i++){
-        plots[i] = plot{empty, false, 0};
+    // Set all of the plots to an empty, with nothing in the active set
+    num_plots = numPlots;
+    plots.assign(num_plots, plot{empty, false, 0});
+    active_bits.assign((num_plots + 63) / 64, 0);
+    refs.assign(num_plots, plot_ref{-1, -1, -1});
+    active_list.clear();
+
+    // Nothing is scheduled to mature yet
+    wheel.assign(WHEEL_SIZE, std::vector<int>());
+    wheel_mask = WHEEL_SIZE - 1;
+    ready_list.clear();
+
+    // Nothing has happened yet
+    history.clear();
+    today = day_record{curr_day, coins, 0, 0, 0, 0, 0};
+
+}
+
+// Active set bookkeeping
+// Plots are added when planted and removed when harvested or wiped out.
+// Removal swaps the last entry of the dense list into the freed slot.
+void GameState::mark_active(int index) {
+    if (refs[index].active_pos >= 0) return;
+    active_bits[index >> 6] |= (uint64_t) 1 << (index & 63);
+    refs[index].active_pos = (int) active_list.size();
+    active_list.push_back(index);
+}
+void GameState::mark_inactive(int index) {
+    int pos = refs[index].active_pos;
+    if (pos < 0) return;
+    active_bits[index >> 6] &= ~((uint64_t) 1 << (index & 63));
+    int last = active_list.back();
+    active_list[pos] = last;
+    refs[last].active_pos = pos;
+    active_list.pop_back();
+    refs[index].active_pos = -1;
+}
+int GameState::active_plots() {
+    return (int) active_list.size();
+}
+
+// Maturity scheduling
+// A plot sits either in the wheel bucket for its maturity day or on the
+// ready list. Both are dense lists with positions tracked per plot, so
+// cancelling an entry is a swap-remove.
+void GameState::schedule(int index, int maturity_day) {
+    std::vector<int>* list;
+    int slot;
+    if (maturity_day <= curr_day) {
+        slot = READY_SLOT;
+        list = &ready_list;
+    } else {
+        // every pending maturity has to fit in the wheel without wrapping
+        if (maturity_day - curr_day > wheel_mask) {
+            grow_wheel(maturity_day - curr_day);
+        }
+        slot = maturity_day & wheel_mask;
+        list = &wheel[slot];
+    }
+    refs[index].sched_slot = slot;
+    refs[index].sched_pos = (int) list->size();
+    list->push_back(index);
+}
+void GameState::unschedule(int index) {
+    int slot = refs[index].sched_slot;
+    if (slot == -1) return;
+    std::vector<int>& list = (slot == READY_SLOT) ? ready_list : wheel[slot];
+    int pos = refs[index].sched_pos;
+    int last = list.back();
+    list[pos] = last;
+    refs[last].sched_pos = pos;
+    list.pop_back();
+    refs[index].sched_slot = -1;
+    refs[index].sched_pos = -1;
+}
+void GameState::grow_wheel(int span) {
+    // double until span fits, then re-bucket everything still pending
+    int size = wheel_mask + 1;
+    while (size <= span) size *= 2;
+    std::vector<std::vector<int> > old;
+    old.swap(wheel);
+    wheel.assign(size, std::vector<int>());
+    wheel_mask = size - 1;
+    for (int b = 0; b < (int) old.size(); b++) {
+        for (int i = 0; i < (int) old[b].size(); i++) {
+            int index = old[b][i];
+            int maturity = plots[index].planted_day + plots[index].type.grow_time;
+            refs[index].sched_slot = maturity & wheel_mask;
+            refs[index].sched_pos = (int) wheel[maturity & wheel_mask].size();
+            wheel[maturity & wheel_mask].push_back(index);
+        }
     }
+}
+
+// Resets a plot to empty and drops it from the active set and the wheel
+void GameState::clear_plot(int index) {
+    plots[index] = plot_raw{empty, false, 0};
+    mark_inactive(index);
+    unschedule(index);
+}
+
+// Days until the crop in a plot can be harvested, 0 once it's ready
+int GameState::days_left(int index) {
+    int left = plots[index].type.grow_time - (curr_day - plots[index].planted_day);
+    return left < 0 ? 0 : left;
+}
 
+// Plots that are ready to harvest, in no particular order
+const std::vector<int>& GameState::ready_plots() {
+    return ready_list;
 }
 
 // Written by Drew
-// begin_event generates a random event and applies
-// the consequences to the farm
+// begin_event draws the day's random events (one, or two in chaos mode,
+// possibly the same one twice) from the current season's weighted table
+// and applies the consequences to the farm
 void GameState::begin_event(){
-    // Generating random number [0, number of events]
-    int pick1 = RandInt() % (int)(sizeof(events)/sizeof(events[0]));
-    //Generate second random number in the case of chaos mode
-    int pick2 = RandInt() % (int)(sizeof(events)/sizeof(events[0]));
+    int picks[MAX_EVENTS_PER_DAY];
+    event_tables[season_of(curr_day)].draw_many(picks, events_per_day);
+    for (int i = 0; i < events_per_day; i++) {
+        apply_event(picks[i]);
+    }
+}
 
-    event rand_event = events[pick1];
-    event_occurred[pick1] = true;
+// Replaces the event weights for a season and rebuilds its table
+void GameState::set_event_weights(int season, const int* weights){
+    event_tables[season].set_weights(weights, (int)(sizeof(events)/sizeof(events[0])));
+}
+
+// Season (0 = spring to 3 = winter) that a given day falls in
+int GameState::season_of(int day){
+    return ((day - 1) / SEASON_LENGTH) % NUMBER_OF_SEASONS;
+}
+
+// Written by Drew
+// apply_event applies the consequences of events[pick] to the farm
+void GameState::apply_event(int pick){
+    const event& rand_event = events[pick];
+    event_occurred[pick] = true;
+    today.events |= (uint16_t) (1 << pick);
 
     // Deciding whether to add money or subtract it
     if(rand_event.isPenalty){
@@ -89,38 +227,60 @@ void GameState::begin_event(){
         total_stats.total_money_earned += rand_event.moneyAmount;
     }
 
-    wipeout(rand_event.wipeout_list);
-
-   //If in chaos mode, generate a second random event (could be a repeat)
-    if (difficulty == 1) {
-       event rand_event2 = events[pick2];
-      event_occurred[pick2] = true;
-
-      // Deciding whether to add money or subtract it
-      if(rand_event2.isPenalty){
-        coins -= rand_event2.moneyAmount;
-        //Update game statistic of total money lost
-        total_stats.total_money_lost += rand_event2.moneyAmount;
-        //Set the coins to 0 if they are a negative value
-        if (coins < 0) {
-           coins = 0;
-         }
-      } else {
-         coins += rand_event2.moneyAmount;
-         //Update game statistic of total money earned
-         total_stats.total_money_earned += rand_event2.moneyAmount;
-      }
+    if (shard) shard->record_event(pick, rand_event.isPenalty, rand_event.moneyAmount);
 
-    wipeout(rand_event2.wipeout_list);
-    }
+    wipeout(rand_event.wipeout_list);
 }
 
 // Written by Drew
 // wipeout takes a vector of indices and destroys the
 // corresponding crops
-void GameState::wipeout(std::vector<int> wl){
-    for(int i = 0; i < wl.size(); i++){
-        plots[wl.at(i)] = plot_raw{empty, false, 0};
+// The indices refer to the 12-plot layout, so on a bigger farm index i
+// covers plots [i * num_plots / 12, (i + 1) * num_plots / 12). Runs of
+// consecutive indices are merged into a single range.
+void GameState::wipeout(const std::vector<int>& wl){
+    int i = 0, n = (int) wl.size();
+    while (i < n) {
+        int first = wl[i], last = wl[i];
+        while (i + 1 < n && wl[i+1] == last + 1) {
+            last = wl[++i];
+        }
+        ++i;
+        wipeout_range((int) ((long long) first * num_plots / NUMBER_OF_PLOTS),
+                      (int) ((long long) (last + 1) * num_plots / NUMBER_OF_PLOTS));
+    }
+}
+
+// Destroys the crops in plots [first, last)
+// Costs time proportional to the occupied plots in the range: the active list
+// is walked directly when that's cheaper than scanning the bitset words.
+void GameState::wipeout_range(int first, int last){
+    if (first < 0) first = 0;
+    if (last > num_plots) last = num_plots;
+    if (first >= last || active_list.empty()) return;
+
+    if ((long long) active_list.size() * 64 < (long long) (last - first)) {
+        // few occupied plots, walk backwards so removals don't skip entries
+        for (int pos = (int) active_list.size() - 1; pos >= 0; pos--) {
+            int index = active_list[pos];
+            if (index >= first && index < last) {
+                record_plot(&today.wiped, index);
+                clear_plot(index);
+            }
+        }
+        return;
+    }
+
+    // otherwise only visit the set bits in range
+    for (int word = first >> 6; word <= (last - 1) >> 6; word++) {
+        uint64_t bits = active_bits[word];
+        while (bits) {
+            int index = (word << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (index < first || index >= last) continue;
+            record_plot(&today.wiped, index);
+            clear_plot(index);
+        }
     }
 }
 
@@ -138,14 +298,21 @@ void GameState::plant(plot *p, crop_type *c) {
       //Update game statistic of total money lost
       total_stats.total_money_lost += ((*c).seed_price + (*c).seed_price);
       //Update the state of the selected plot
+      int index = (int) (p - plots.data());
+      unschedule(index);
       (*p).active = true;
-      (*p).days_active = 0;
+      (*p).planted_day = curr_day;
       (*p).type = (*c);
+      mark_active(index);
+      record_plot(&today.planted, index);
+      //Register the plot to become ready on the day it matures
+      schedule(index, curr_day + (*c).grow_time);
       //Check if planted crop was a carrot
       if ((*c).crop_id == 1) {
          //If so, update game statistic of total carrots planted
          total_stats.carrots_planted++;
       }
+      if (shard) shard->record_planted((*c).crop_id, (*c).seed_price);
    }
    //If the user cannot afford the seeds, nothing should happen
 }
@@ -156,54 +323,158 @@ void GameState::plant(plot *p, crop_type *c) {
 //It checks if the selected plot is ready to be harvested, and
 //if so, it harvests the crop and updates the user stats accordingly.
 void GameState::harvest(plot *p) {
+   int index = (int) (p - plots.data());
    //Make sure the selected plot is ready for harvest
-   if ((*p).days_active >= ((*p).type).grow_time) {
+   if (refs[index].sched_slot == READY_SLOT) {
       //Add the sale price of the crop to the user's total money
       coins += ((*p).type).sale_price;
       //Update game statistic of total money earned
       total_stats.total_money_earned += ((*p).type).sale_price;
+      if (shard) shard->record_harvest(((*p).type).crop_id, ((*p).type).sale_price);
+      record_plot(&today.harvested, index);
       //Update the state of the selected plot
-      (*p).active = false;
-      (*p).days_active = 0;
-      (*p).type = empty;
+      clear_plot(index);
    }
    //If the plot is not ready for harvest, nothing should happen
 }
 
+//Harvests every plot that is ready in a single pass and returns which
+//plots changed along with the coins earned, so that callers can refresh
+//just those plots once. Only plots on the ready list are visited, last
+//first, since each harvest removes the last entry.
+harvest_delta GameState::harvest_all() {
+   harvest_delta delta;
+   delta.coins = coins;
+   delta.changed.reserve(ready_list.size());
+   while (!ready_list.empty()) {
+      int index = ready_list.back();
+      harvest(&plots[index]);
+      delta.changed.push_back(index);
+   }
+   delta.coins = coins - delta.coins;
+   return delta;
+}
+
 //Written by Annie
 //This function has no arguments, and its return type is void.
 //It makes sure the user still has some amount of money, and
 //if so, starts the new day. The new day involves incrementing
-//the day counter, incrementing the number of days that each
-//active plot has been active, and cue a random event to happen.
+//the day counter, moving crops that mature today onto the
+//ready list, and cue a random event to happen.
 void GameState::new_day() {
+   PERF_REGION(perf, "GameState::new_day");
    //Make sure the user isn't dead yet
    stillAlive = (coins > 0);
    if (stillAlive) {
-      //Increment the day counter
-      curr_day++;
-      //Update game statistic for maximum days survived if applicable
-      if (curr_day > total_stats.max_days_survived) {
-         total_stats.max_days_survived = curr_day;
-      }
-      //Loop through each plot, and if the plot has a crop growing on it,
-      //increment the number of days the plot has been active
-      for (int i = 0; i < NUMBER_OF_PLOTS; i++) {
-         if (plots[i].active) {
-            (plots[i].days_active)++;
-         }
-      }
-      //Reset all boolean variables keeping track of what event has occurred
-      //that day to false
-      for(int i = 0; i < 10; i++) {
-         event_occurred[i] = false;
-      }
+      advance_day();
       //Cue the random event for the day
       GameState::begin_event();
    }
    //Do not start a new day if the user is broke
 }
 
+//Moves the calendar forward one day without any random event: bumps the
+//day counter and the max days stat, moves crops that mature today onto the
+//ready list, and clears yesterday's events.
+void GameState::advance_day() {
+   //File away what happened today
+   end_day();
+   //Increment the day counter
+   curr_day++;
+   //Update game statistic for maximum days survived if applicable
+   if (curr_day > total_stats.max_days_survived) {
+      total_stats.max_days_survived = curr_day;
+   }
+   //Move every crop that matures today from its wheel bucket
+   //to the ready list
+   std::vector<int>& due = wheel[curr_day & wheel_mask];
+   for (int i = 0; i < (int) due.size(); i++) {
+      refs[due[i]].sched_slot = READY_SLOT;
+      refs[due[i]].sched_pos = (int) ready_list.size();
+      ready_list.push_back(due[i]);
+   }
+   due.clear();
+   //Reset all boolean variables keeping track of what event has occurred
+   //that day to false
+   for(int i = 0; i < 10; i++) {
+      event_occurred[i] = false;
+   }
+}
+
+//Advances up to the given number of days in one call, without any UI.
+//Each day plays out like new_day (and draws the same random numbers, so a
+//seeded run matches clicking through day by day), followed by the policy:
+//FF_HARVEST harvests everything that's ready, and FF_HARVEST_AND_REPLANT
+//also plants the replant crop in every empty plot it can afford.
+//Stops early if the player goes broke, without drawing anything for the
+//day it would have played next.
+ff_result GameState::fast_forward(int days, int policy, const crop_type* replant) {
+   PERF_REGION(perf, "GameState::fast_forward");
+   ff_result result = ff_result{0, coins, 0, 0, true};
+   crop_type crop = replant ? *replant : empty;
+
+   while (result.days < days) {
+      stillAlive = (coins > 0);
+      if (!stillAlive) break;
+      advance_day();
+      begin_event();
+      result.days++;
+
+      if (policy == FF_NONE) continue;
+      result.harvested += harvest_ready();
+      if (policy == FF_HARVEST_AND_REPLANT && replant) {
+         result.planted += plant_empty(&crop);
+      }
+   }
+   stillAlive = (coins > 0);
+   result.survived = stillAlive;
+   result.coins_delta = coins - result.coins_delta;
+   PERF_ITEMS(perf, result.days);
+   return result;
+}
+
+//Harvests everything on the ready list, returns how many plots that was
+int GameState::harvest_ready() {
+   int count = (int) ready_list.size();
+   while (!ready_list.empty()) {
+      harvest(&plots[ready_list.back()]);
+   }
+   return count;
+}
+
+//Plants crop c in empty plots, lowest index first, for as long as the seeds
+//are affordable. Empty plots are found from the clear bits of the active set.
+int GameState::plant_empty(crop_type* c) {
+   int count = 0;
+   for (int word = 0; word < (int) active_bits.size(); word++) {
+      uint64_t free_bits = ~active_bits[word];
+      while (free_bits) {
+         int index = (word << 6) + __builtin_ctzll(free_bits);
+         free_bits &= free_bits - 1;
+         if (index >= num_plots) return count;
+         if ((*c).seed_price >= coins) return count;
+         plant(&plots[index], c);
+         count++;
+      }
+   }
+   return count;
+}
+
+//Adds the day that's ending to the history and starts a fresh record for
+//the next one, which begins with today's closing balance
+void GameState::end_day() {
+   today.day = curr_day;
+   today.coins_delta = coins - today.coins;
+   today.coins = coins;
+   history.append(today);
+   today = day_record{curr_day + 1, coins, 0, 0, 0, 0, 0};
+}
+
+//Marks a plot in one of today's bitmasks, if it's one that's tracked
+void GameState::record_plot(uint16_t* mask, int index) {
+   if (index < HISTORY_PLOT_BITS) *mask |= (uint16_t) (1 << index);
+}
+
 //Written by Annie
 //This function has no arguments and the return type is a stats struct.
 //Accessor method so that the game can keep track of statistics from
@@ -5,6 +5,11 @@
 
 #include <vector>
 #include <cstring>
+#include <cstdint>
+
+#include "DayHistory.h"
+#include "EventTable.h"
+#include "StatsAggregator.h"
 
 
 // Written by Annie and Drew
@@ -41,13 +46,40 @@ struct crop_type_raw {
 // Written by Annie and Drew
 // Stores the properties of the plots that will make up the farm
 // These include the type of crop on the plot, whether or not
-// the plot is active, and how many days the plot has been active.
+// the plot is active, and the day the crop was planted on.
+// (How long it has been growing is curr_day - planted_day, see
+// GameState::days_left, so nothing needs to be updated per day.)
 struct plot_raw {
     crop_type type;
     bool active;
-    int days_active;
+    int planted_day;
 } typedef plot;
 
+// Result of GameState::harvest_all
+// Lists the plots that were harvested (and so need redrawing) and the
+// total number of coins the harvest brought in.
+struct harvest_delta_raw {
+    std::vector<int> changed;
+    int coins;
+} typedef harvest_delta;
+
+// Policies for GameState::fast_forward
+#define FF_NONE 0
+#define FF_HARVEST 1
+#define FF_HARVEST_AND_REPLANT 2
+
+// Result of GameState::fast_forward
+// Includes how many days were actually simulated, the net change in
+// coins, how many plots were harvested and planted along the way, and
+// whether the player still has money at the end.
+struct ff_result_raw {
+    int days;
+    int coins_delta;
+    int harvested;
+    int planted;
+    bool survived;
+} typedef ff_result;
+
 //Written by Annie
 // Stores the up to date stats of the game as it is running
 // These include the maximum number of days survived by the
@@ -83,6 +115,62 @@ const event fertilizer = event{"Free fertilizer!", "Gift from the neighbors!", f
 const event pandemic = event{"Cornona Virus :O", "A deadly plant virus!!!", true, 60, std::vector<int>{0, 1, 2, 3, 4, 5}};
 const event mystery = event{"Where'd they go?", "It's a mystery event!", true, 70, std::vector<int>{3, 4, 5, 6, 7, 8}};
 
+// Starting coins for normal mode and chaos mode
+#define START_COINS 500
+#define CHAOS_START_COINS 400
+
+// Balance settings
+// Everything the game's balance hangs on besides the event odds: the crop
+// prices and grow times (indexed by crop_id, so crops[0] is the empty
+// crop; plant and fast_forward take the crop to use, so these are for the
+// caller to pass in), what each event costs or pays (same order as
+// GameState::events), the starting coins, and how chaos mode scales the
+// events (bad ones are multiplied, good ones divided).
+// default_game_config is the game as it ships; a GameState can be built
+// from another one to try out a different balance, see tools/sweep.cpp.
+struct game_config_raw {
+    crop_type crops[NUMBER_OF_CROP_TYPES];
+    int event_amounts[10];
+    int start_coins;
+    int chaos_start_coins;
+    int chaos_penalty_multiplier;
+    int chaos_bonus_divisor;
+} typedef game_config;
+
+const game_config default_game_config = game_config{
+    {empty, carrot, tomato, corn, lettuce},
+    {flood.moneyAmount, tornado.moneyAmount, fire.moneyAmount, sunny_day.moneyAmount,
+     thief.moneyAmount, rain.moneyAmount, bug.moneyAmount, fertilizer.moneyAmount,
+     pandemic.moneyAmount, mystery.moneyAmount},
+    START_COINS, CHAOS_START_COINS, 2, 2
+};
+
+// Seasons shift the odds of each event, see the weight tables below
+#define SEASON_LENGTH 7
+#define NUMBER_OF_SEASONS 4
+// Most random events that can happen on a single day
+#define MAX_EVENTS_PER_DAY 4
+
+// Relative chance of each event (same order as GameState::events) in
+// spring, summer, fall and winter, for normal mode and chaos mode.
+// Spring brings rain and floods, summer fires and bugs, fall thieves and
+// plant viruses, and winter is mostly quiet apart from thieves.
+// Chaos mode makes the bad events more likely across the board.
+const int normal_event_weights[NUMBER_OF_SEASONS][10] = {
+    //fl tor fire sun thief rain bug fert virus myst
+    { 4, 1, 1, 2, 2, 4, 2, 3, 1, 1 },
+    { 1, 2, 4, 4, 2, 1, 3, 1, 1, 1 },
+    { 1, 1, 2, 2, 3, 2, 1, 2, 3, 2 },
+    { 1, 1, 1, 3, 4, 1, 1, 2, 1, 2 },
+};
+const int chaos_event_weights[NUMBER_OF_SEASONS][10] = {
+    //fl tor fire sun thief rain bug fert virus myst
+    { 6, 2, 2, 1, 3, 2, 3, 1, 2, 2 },
+    { 2, 3, 6, 2, 3, 1, 4, 1, 2, 2 },
+    { 2, 2, 3, 1, 4, 1, 2, 1, 4, 3 },
+    { 2, 2, 2, 1, 6, 1, 2, 1, 2, 3 },
+};
+
 // Written by Drew and Annie
 // Represents the current state of the farm.
 // This includes the amount of money you have
@@ -92,31 +180,58 @@ const event mystery = event{"Where'd they go?", "It's a mystery event!", true, 7
 // each event occurs each day, the number of the day you are on, the methods all
 // defined and described in GameState.cpp, and the running game stats described 
 // in the stat struct definition.
+//
+// Every day also leaves a small record behind in history: which events
+// fired, the change in coins, and which plots were planted, harvested or
+// wiped out.
+//
+// The number of plots is picked at construction time so that simulations can
+// run much bigger farms than the 12 plots shown on screen. Occupied plots are
+// tracked in an active set (a bitset plus a dense list of indices) so that
+// day advance, harvest_all and wipeouts only touch occupied plots. Event
+// wipeout lists are written against the 12-plot layout; on bigger farms each
+// of those indices stands for a 1/12th slice of the field.
+//
+// Crop maturity is tracked with a timing wheel: planting registers the plot
+// in the bucket for the day it matures, and each new day moves that day's
+// bucket onto the ready list. Day advance is O(1) amortized per planting and
+// ready_plots() is the list of harvestable plots, with no per-plot scans.
 class GameState {
     public:
 
         //Difficulty setting
         int difficulty;
 
-        // The plots on the screen that can grow crops
-        plot plots[NUMBER_OF_PLOTS];
+        // The plots that can grow crops, the first NUMBER_OF_PLOTS of which
+        // are the ones shown on screen
+        int num_plots;
+        std::vector<plot> plots;
 
         // The random events that can occur in between days
         event events[10] = {flood, tornado, fire, sunny_day, thief, rain, bug, fertilizer, pandemic, mystery};
         bool event_occurred[10];
 
+        // Weighted tables the daily events are drawn from, one per season,
+        // and how many events are drawn each day (two in chaos mode)
+        EventTable event_tables[NUMBER_OF_SEASONS];
+        int events_per_day;
+
         //Misc. game stats
         int coins;
         int curr_day;
         bool stillAlive;
 
+        // Optional stats shard for parallel simulations; when set, planting,
+        // harvesting and events are also counted there (see StatsAggregator.h)
+        StatsShard* shard = nullptr;
+
         // Drew
-        char* test();
+        const char* test();
 
         //Constructor
 
         // Drew
-        GameState(int);
+        GameState(int diff, int numPlots = NUMBER_OF_PLOTS, const game_config& config = default_game_config);
         
         // For description of each method see GameState.cpp
 
@@ -127,14 +242,66 @@ class GameState {
         void new_day();
         // Drew
         void begin_event();
+        void apply_event(int pick);
+        void set_event_weights(int season, const int* weights);
+        int season_of(int day);
         // Annie
         void harvest(plot*);
         // Drew
-        void wipeout(std::vector<int>);
+        void wipeout(const std::vector<int>&);
+        void wipeout_range(int first, int last);
+        harvest_delta harvest_all();
+        int active_plots();
+        int days_left(int index);
+        const std::vector<int>& ready_plots();
+        ff_result fast_forward(int days, int policy, const crop_type* replant = nullptr);
         // Annie
         stats get_game_stats();
 
     private:
         stats total_stats;
+
+        // the day in progress, added to history when the next day starts
+        // (until then its coins are the balance the day started with)
+        day_record today;
+        void record_plot(uint16_t* mask, int index);
+        void end_day();
+
+        // per-plot positions in the active list and the maturity wheel,
+        // kept together so each update touches a single cache line
+        // sched_slot holds a plot's wheel bucket, READY_SLOT once it's on
+        // the ready list, or -1 when nothing is scheduled
+        struct plot_ref {
+            int active_pos;
+            int sched_slot;
+            int sched_pos;
+        };
+        std::vector<plot_ref> refs;
+
+        // active set of occupied plots
+        std::vector<uint64_t> active_bits;
+        std::vector<int> active_list;
+        void mark_active(int index);
+        void mark_inactive(int index);
+
+        // maturity timing wheel, bucket = maturity day & wheel_mask
+        std::vector<std::vector<int> > wheel;
+        int wheel_mask;
+        std::vector<int> ready_list;
+        void schedule(int index, int maturity_day);
+        void unschedule(int index);
+        void grow_wheel(int span);
+        void clear_plot(int index);
+
+        // helpers shared by new_day and fast_forward
+        void advance_day();
+        int harvest_ready();
+        int plant_empty(crop_type* c);
+
+    public:
+        // What happened on each day that has ended so far, in a fixed
+        // amount of memory however long the game runs (see DayHistory.h),
+        // kept at the end since it's big and rarely touched
+        DayHistory history;
 };
 #endif // GameState_H 
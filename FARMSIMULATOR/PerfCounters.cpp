@@ -0,0 +1,191 @@
+#include "PerfCounters.h"
+
+#ifdef PERF_COUNTERS
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Totals for one region, added to by every thread
+struct perf_region_raw {
+    const char* name;
+    std::atomic<long long> entries; // outermost only
+    std::atomic<long long> items;
+    std::atomic<long long> counts[PERF_EVENTS];
+    std::atomic<long long> nanoseconds;
+} typedef perf_region;
+
+static perf_region regions[PERF_MAX_REGIONS];
+static std::atomic<int> regionCount(0);
+static std::mutex registerLock;
+
+static const char* eventNames[PERF_EVENTS] = {"cycles", "instructions", "cache misses", "branch misses"};
+// which events at least one thread managed to open, and the first reason
+// one couldn't be
+static std::atomic<int> openedEvents(0);
+static std::atomic<int> openError(0);
+
+// One counter group per thread
+struct perf_thread {
+    int leader = -2; // not tried yet, -1 if it couldn't be opened
+    int fds[PERF_EVENTS];
+    int slot[PERF_EVENTS]; // place in the group read, -1 if not open
+    int opened = 0;
+    int depth[PERF_MAX_REGIONS] = {};
+    long long pendingItems[PERF_MAX_REGIONS] = {};
+
+    perf_thread() {
+        for (int e = 0; e < PERF_EVENTS; e++) slot[e] = -1;
+    }
+
+    ~perf_thread() {
+#ifdef __linux__
+        if (leader < 0) return;
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            if (slot[e] >= 0) close(fds[e]);
+        }
+#endif
+    }
+
+    void open() {
+        leader = -1;
+        for (int e = 0; e < PERF_EVENTS; e++) slot[e] = -1;
+#ifdef __linux__
+        static const unsigned long long configs[PERF_EVENTS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+        int mask = 0;
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            int fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+            if (fd < 0) {
+                int none = 0;
+                openError.compare_exchange_strong(none, errno);
+                // without cycles there's no group to join
+                if (e == 0) return;
+                continue;
+            }
+            if (e == 0) leader = fd;
+            fds[e] = fd;
+            slot[e] = opened++;
+            mask |= 1 << e;
+        }
+        openedEvents.fetch_or(mask);
+#endif
+    }
+
+    // current counters into values, in event order (0 for ones not open),
+    // then the wall clock in nanoseconds
+    void read(long long* values) {
+        if (leader == -2) open();
+        for (int e = 0; e < PERF_EVENTS; e++) values[e] = 0;
+#ifdef __linux__
+        if (leader >= 0) {
+            unsigned long long group[PERF_EVENTS + 1];
+            if (::read(leader, group, sizeof(group)) > 0) {
+                for (int e = 0; e < PERF_EVENTS; e++) {
+                    if (slot[e] >= 0) values[e] = (long long) group[1 + slot[e]];
+                }
+            }
+        }
+#endif
+        values[PERF_EVENTS] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+static thread_local perf_thread counters;
+
+int PerfCounters::region(const char* name) {
+    std::lock_guard<std::mutex> guard(registerLock);
+    int count = regionCount.load();
+    for (int i = 0; i < count; i++) {
+        if (!strcmp(regions[i].name, name)) return i;
+    }
+    // past the limit everything shares the last region
+    if (count == PERF_MAX_REGIONS) return count - 1;
+    regions[count].name = name;
+    regionCount.store(count + 1);
+    return count;
+}
+
+PerfScope::PerfScope(int region) : items(1), region(region) {
+    outermost = counters.depth[region]++ == 0;
+    if (outermost) counters.read(start);
+}
+
+PerfScope::~PerfScope() {
+    counters.pendingItems[region] += items;
+    if (--counters.depth[region] > 0) return;
+    long long end[PERF_EVENTS + 1];
+    counters.read(end);
+    perf_region& r = regions[region];
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        r.counts[e].fetch_add(end[e] - start[e], std::memory_order_relaxed);
+    }
+    r.nanoseconds.fetch_add(end[PERF_EVENTS] - start[PERF_EVENTS], std::memory_order_relaxed);
+    r.entries.fetch_add(1, std::memory_order_relaxed);
+    r.items.fetch_add(counters.pendingItems[region], std::memory_order_relaxed);
+    counters.pendingItems[region] = 0;
+}
+
+// per item figure, or a dash if the counter isn't there
+static void printPerItem(FILE* out, bool have, double total, long long items, const char* format) {
+    if (have && items) fprintf(out, format, total / items);
+    else fprintf(out, "%10s", "-");
+}
+
+void PerfCounters::report(FILE* out) {
+    int count = regionCount.load();
+    if (!count) return;
+    int opened = openedEvents.load();
+    fprintf(out, "\nhardware counters:");
+    for (int e = 0; e < PERF_EVENTS; e++) {
+        if (opened & (1 << e)) fprintf(out, " %s", eventNames[e]);
+    }
+    if (opened != (1 << PERF_EVENTS) - 1) {
+        fprintf(out, "%s (perf_event_open: %s", opened ? ", the rest unavailable" : " unavailable",
+                openError.load() ? strerror(openError.load()) : "not supported here");
+#ifdef __linux__
+        FILE* paranoid = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+        int level;
+        if (paranoid && fscanf(paranoid, "%d", &level) == 1) fprintf(out, ", perf_event_paranoid is %d", level);
+        if (paranoid) fclose(paranoid);
+#endif
+        fprintf(out, ")");
+    }
+    fprintf(out, "\n%-24s %10s %12s %10s %10s %10s %10s %10s\n", "region", "entries", "items",
+            "ns/item", "cycles/it", "IPC", "cache/it", "branch/it");
+    bool haveCycles = opened & 1, haveInstructions = opened & 2;
+    for (int i = 0; i < count; i++) {
+        perf_region& r = regions[i];
+        long long items = r.items.load();
+        long long cycles = r.counts[0].load(), instructions = r.counts[1].load();
+        fprintf(out, "%-24s %10lld %12lld", r.name, r.entries.load(), items);
+        printPerItem(out, true, (double) r.nanoseconds.load(), items, "%10.1f");
+        printPerItem(out, haveCycles, (double) cycles, items, "%10.1f");
+        if (haveCycles && haveInstructions && cycles) fprintf(out, "%10.2f", (double) instructions / cycles);
+        else fprintf(out, "%10s", "-");
+        printPerItem(out, (opened & 4) != 0, (double) r.counts[2].load(), items, "%10.3f");
+        printPerItem(out, (opened & 8) != 0, (double) r.counts[3].load(), items, "%10.3f");
+        fprintf(out, "\n");
+    }
+}
+
+#endif // PERF_COUNTERS
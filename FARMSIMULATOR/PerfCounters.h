@@ -0,0 +1,65 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+// Hardware counters around named regions of the engine
+// Only built in with PERF_COUNTERS defined (make perf builds the
+// benchmarks that way into build/perf); otherwise the macros below are
+// empty and cost nothing, which is how the game and the normal tools are
+// built.
+//
+//   PERF_REGION(perf, "GameState::new_day");  counts until the end of the scope
+//   PERF_ITEMS(perf, days);                   items this entry stands for (1 if not set)
+//   PERF_REPORT(stdout);                      table of every region so far
+//
+// On Linux each thread opens one perf_event_open group (cycles,
+// instructions, cache misses, branch misses, user space only) the first
+// time it enters a region, and reads it on the way into and out of the
+// outermost entry, so recursive regions like UIElement::render are counted
+// once per outer call while every nested entry still adds its items.
+// Counts are inclusive of any regions nested inside. If the counters
+// can't be opened (no PMU in a VM, perf_event_paranoid, not Linux) the
+// regions still count entries, items and wall time, and the report says
+// why the counter columns are missing.
+#ifdef PERF_COUNTERS
+
+#include <cstdio>
+
+// Limits for the instrumentation
+#define PERF_MAX_REGIONS 32
+#define PERF_EVENTS 4
+
+class PerfScope {
+    public:
+        explicit PerfScope(int region);
+        ~PerfScope();
+
+        long long items;
+
+    private:
+        int region;
+        bool outermost;
+        long long start[PERF_EVENTS + 1]; // counters, then nanoseconds
+};
+
+class PerfCounters {
+    public:
+        // index of the region with this name, registered on first use
+        static int region(const char* name);
+        static void report(FILE* out);
+};
+
+#define PERF_REGION(scope, name) \
+    static const int scope##Region = PerfCounters::region(name); \
+    PerfScope scope(scope##Region)
+#define PERF_ITEMS(scope, n) ((scope).items = (n))
+#define PERF_REPORT(out) PerfCounters::report(out)
+
+#else
+
+#define PERF_REGION(scope, name)
+#define PERF_ITEMS(scope, n)
+#define PERF_REPORT(out)
+
+#endif // PERF_COUNTERS
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,180 @@
+#include "StatsAggregator.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Single-writer increment, see StatsShard
+static inline void bump(std::atomic<long long>& counter, long long amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void StatsShard::record_planted(int crop_id, int seed_price) {
+    if (crop_id >= 0 && crop_id < NUMBER_OF_CROP_TYPES) {
+        bump(crops_planted[crop_id], 1);
+        game_crop_profit[crop_id] -= seed_price;
+        game_crops_planted |= 1 << crop_id;
+    }
+    bump(money_lost, seed_price);
+}
+
+void StatsShard::record_harvest(int crop_id, int sale_price) {
+    if (crop_id >= 0 && crop_id < NUMBER_OF_CROP_TYPES) game_crop_profit[crop_id] += sale_price;
+    bump(money_earned, sale_price);
+}
+
+void StatsShard::record_event(int event_index, bool penalty, int amount) {
+    if (event_index >= 0 && event_index < NUMBER_OF_EVENT_TYPES) bump(events_fired[event_index], 1);
+    bump(penalty ? money_lost : money_earned, amount);
+}
+
+void StatsShard::record_game(int days, long long final_coins) {
+    bump(games, 1);
+    bump(days_survived, days);
+    bump(sketch_counts[SKETCH_DAYS_SURVIVED][QuantileSketch::bucket_of(days)], 1);
+    bump(sketch_counts[SKETCH_FINAL_COINS][QuantileSketch::bucket_of(final_coins)], 1);
+    // then start the next game's crop tallies from scratch
+    for (int c = 0; c < NUMBER_OF_CROP_TYPES; c++) {
+        if (game_crops_planted & (1 << c)) {
+            bump(sketch_counts[SKETCH_CROP_PROFIT(c)][QuantileSketch::bucket_of(game_crop_profit[c])], 1);
+        }
+        game_crop_profit[c] = 0;
+    }
+    game_crops_planted = 0;
+}
+
+// Buckets of a magnitude: exact below SKETCH_SUB_BUCKETS, then
+// SKETCH_SUB_BUCKETS per power of two, picked by the bits just below the
+// highest set bit
+static inline int magnitude_bucket(unsigned long long magnitude) {
+    const unsigned long long largest = (1ULL << SKETCH_MAX_BITS) - 1;
+    if (magnitude > largest) magnitude = largest;
+    if (magnitude < SKETCH_SUB_BUCKETS) return (int) magnitude;
+    int top = 63 - __builtin_clzll(magnitude);
+    int shift = top - SKETCH_SUB_BITS;
+    return SKETCH_SUB_BUCKETS * (shift + 1) + (int) ((magnitude >> shift) & (SKETCH_SUB_BUCKETS - 1));
+}
+
+int QuantileSketch::bucket_of(long long value) {
+    // negatives count down from the middle, so buckets stay in value order
+    if (value < 0) return SKETCH_MAGNITUDE_BUCKETS - 1 - magnitude_bucket(0ULL - (unsigned long long) value);
+    return SKETCH_MAGNITUDE_BUCKETS + magnitude_bucket((unsigned long long) value);
+}
+
+long long QuantileSketch::bucket_value(int bucket) {
+    bool negative = bucket < SKETCH_MAGNITUDE_BUCKETS;
+    int m = negative ? SKETCH_MAGNITUDE_BUCKETS - 1 - bucket : bucket - SKETCH_MAGNITUDE_BUCKETS;
+    long long value = m;
+    if (m >= SKETCH_SUB_BUCKETS) {
+        int shift = m / SKETCH_SUB_BUCKETS - 1;
+        long long low = (long long) (SKETCH_SUB_BUCKETS + m % SKETCH_SUB_BUCKETS) << shift;
+        value = low + ((1LL << shift) - 1) / 2;
+    }
+    return negative ? -value : value;
+}
+
+void QuantileSketch::add(long long value, long long n) {
+    counts[bucket_of(value)] += n;
+    total += n;
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    for (int i = 0; i < SKETCH_BUCKETS; i++) counts[i] += other.counts[i];
+    total += other.total;
+}
+
+long long QuantileSketch::quantile(double fraction) const {
+    if (total <= 0) return 0;
+    long long target = (long long) (fraction * total);
+    long long seen = 0;
+    for (int i = 0; i < SKETCH_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen > target) return bucket_value(i);
+    }
+    return bucket_value(SKETCH_BUCKETS - 1);
+}
+
+StatsAggregator::StatsAggregator() {
+    count = 0;
+    for (int i = 0; i < MAX_STATS_SHARDS; i++) {
+        shards[i] = nullptr;
+        storage[i] = nullptr;
+    }
+}
+
+StatsAggregator::~StatsAggregator() {
+    int n = count.load();
+    for (int i = 0; i < n; i++) {
+        StatsShard* shard = shards[i].load();
+        if (shard) shard->~StatsShard();
+        free(storage[i]);
+    }
+}
+
+// Allocates a zeroed shard aligned to a cache line (alignas pads its size
+// to whole lines). C++11 new doesn't honour alignment past the usual 16
+// bytes, so the shard is placed at the first line boundary of a slightly
+// larger malloc, which works the same on every platform the game builds
+// for. Returns nullptr once MAX_STATS_SHARDS is reached.
+StatsShard* StatsAggregator::add_shard() {
+    static_assert(sizeof(StatsShard) % STATS_CACHE_LINE == 0, "shard layout");
+    int index = count.load();
+    // only the thread that wins the slot fills it in
+    while (index < MAX_STATS_SHARDS && !count.compare_exchange_weak(index, index + 1)) {}
+    if (index >= MAX_STATS_SHARDS) return nullptr;
+
+    void* memory = malloc(sizeof(StatsShard) + STATS_CACHE_LINE - 1);
+    if (!memory) return nullptr;
+    uintptr_t aligned = ((uintptr_t) memory + STATS_CACHE_LINE - 1) & ~(uintptr_t) (STATS_CACHE_LINE - 1);
+    StatsShard* shard = new ((void*) aligned) StatsShard();
+    shard->games = 0;
+    shard->days_survived = 0;
+    shard->money_earned = 0;
+    shard->money_lost = 0;
+    for (int i = 0; i < NUMBER_OF_CROP_TYPES; i++) shard->crops_planted[i] = 0;
+    for (int i = 0; i < NUMBER_OF_EVENT_TYPES; i++) shard->events_fired[i] = 0;
+    for (int k = 0; k < NUMBER_OF_SKETCHES; k++) {
+        for (int i = 0; i < SKETCH_BUCKETS; i++) shard->sketch_counts[k][i] = 0;
+    }
+    for (int i = 0; i < NUMBER_OF_CROP_TYPES; i++) shard->game_crop_profit[i] = 0;
+    shard->game_crops_planted = 0;
+    storage[index] = memory;
+    // publish the shard after it's fully initialized
+    shards[index].store(shard, std::memory_order_release);
+    return shard;
+}
+
+int StatsAggregator::shard_count() {
+    return count.load();
+}
+
+// Lock-free merge: every counter of every published shard is read with a
+// relaxed load and summed
+void StatsAggregator::snapshot(stats_totals& totals) {
+    memset(&totals, 0, sizeof(totals));
+    int n = count.load(std::memory_order_acquire);
+    for (int s = 0; s < n; s++) {
+        StatsShard* shard = shards[s].load(std::memory_order_acquire);
+        // slot claimed but not published yet
+        if (!shard) continue;
+        totals.games += shard->games.load(std::memory_order_relaxed);
+        totals.days_survived += shard->days_survived.load(std::memory_order_relaxed);
+        totals.money_earned += shard->money_earned.load(std::memory_order_relaxed);
+        totals.money_lost += shard->money_lost.load(std::memory_order_relaxed);
+        for (int i = 0; i < NUMBER_OF_CROP_TYPES; i++) {
+            totals.crops_planted[i] += shard->crops_planted[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < NUMBER_OF_EVENT_TYPES; i++) {
+            totals.events_fired[i] += shard->events_fired[i].load(std::memory_order_relaxed);
+        }
+        for (int k = 0; k < NUMBER_OF_SKETCHES; k++) {
+            QuantileSketch& sketch = totals.sketches[k];
+            for (int i = 0; i < SKETCH_BUCKETS; i++) {
+                long long n = shard->sketch_counts[k][i].load(std::memory_order_relaxed);
+                sketch.counts[i] += n;
+                sketch.total += n;
+            }
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef STATSAGGREGATOR_H
+#define STATSAGGREGATOR_H
+
+#include <atomic>
+
+// Limits for the aggregation layer
+#define MAX_STATS_SHARDS 256
+#define NUMBER_OF_CROP_TYPES 5
+#define NUMBER_OF_EVENT_TYPES 10
+#define STATS_CACHE_LINE 64
+
+// Quantile sketch resolution: values below 2^SKETCH_SUB_BITS are counted
+// exactly, above that every power of two is split into 2^SKETCH_SUB_BITS
+// buckets (so within about 3% at 5 bits), and magnitudes are capped just
+// under 2^SKETCH_MAX_BITS
+#define SKETCH_SUB_BITS 5
+#define SKETCH_MAX_BITS 40
+#define SKETCH_SUB_BUCKETS (1 << SKETCH_SUB_BITS)
+#define SKETCH_MAGNITUDE_BUCKETS (SKETCH_SUB_BUCKETS * (SKETCH_MAX_BITS - SKETCH_SUB_BITS + 1))
+// negative values mirror the positive ones below them
+#define SKETCH_BUCKETS (2 * SKETCH_MAGNITUDE_BUCKETS)
+
+// Distributions kept per game, see StatsShard::record_game
+#define SKETCH_DAYS_SURVIVED 0
+#define SKETCH_FINAL_COINS 1
+// profit of crop type c (sales minus seeds) in games where it was planted
+#define SKETCH_CROP_PROFIT(c) (2 + (c))
+#define NUMBER_OF_SKETCHES (2 + NUMBER_OF_CROP_TYPES)
+
+// Log-linear histogram of integer values (the HDR histogram layout)
+// Adding a value is one counter increment, so it takes the same fixed
+// memory however many values go in, and two sketches merge by adding
+// their counters. Quantiles are answered from the counters at any time,
+// to within the bucket the value falls in.
+struct QuantileSketch {
+    long long counts[SKETCH_BUCKETS];
+    long long total;
+
+    void add(long long value, long long n = 1);
+    void merge(const QuantileSketch& other);
+    // value below which the given fraction of the values fall, 0 if empty
+    long long quantile(double fraction) const;
+
+    static int bucket_of(long long value);
+    // middle of a bucket's range of values
+    static long long bucket_value(int bucket);
+};
+
+// Stats counters for one simulation thread
+// A GameState with a shard attached adds to it as it plays (see
+// GameState::shard). Only the owning thread writes, so updates are a
+// relaxed load and store with no read-modify-write, while any other
+// thread may read the counters at any time. Each shard starts on its own
+// cache line (and is padded out to whole lines) so that neighbouring
+// threads never share one.
+// The per-game distributions are QuantileSketch counters (merged in
+// snapshot); profit per crop is tallied for the game in progress and goes
+// into them from record_game, along with the days and final coins.
+struct alignas(STATS_CACHE_LINE) StatsShard {
+    std::atomic<long long> games;
+    std::atomic<long long> days_survived;
+    std::atomic<long long> money_earned;
+    std::atomic<long long> money_lost;
+    std::atomic<long long> crops_planted[NUMBER_OF_CROP_TYPES];
+    std::atomic<long long> events_fired[NUMBER_OF_EVENT_TYPES];
+    std::atomic<long long> sketch_counts[NUMBER_OF_SKETCHES][SKETCH_BUCKETS];
+
+    // the game in progress, only ever read by the owning thread
+    long long game_crop_profit[NUMBER_OF_CROP_TYPES];
+    int game_crops_planted; // bit c set once crop type c is planted
+
+    void record_planted(int crop_id, int seed_price);
+    void record_harvest(int crop_id, int sale_price);
+    void record_event(int event_index, bool penalty, int amount);
+    void record_game(int days_survived, long long final_coins);
+};
+
+// Plain merged copy of all shards
+struct stats_totals_raw {
+    long long games;
+    long long days_survived;
+    long long money_earned;
+    long long money_lost;
+    long long crops_planted[NUMBER_OF_CROP_TYPES];
+    long long events_fired[NUMBER_OF_EVENT_TYPES];
+    QuantileSketch sketches[NUMBER_OF_SKETCHES];
+} typedef stats_totals;
+
+// Owns the shards and merges them on demand
+// add_shard is called once per simulation thread; snapshot can be called
+// from any thread while the simulations are running and never blocks them.
+// Totals from a snapshot taken mid-run are not an atomic cut across all
+// counters, but every counter is individually exact. stats_totals holds
+// the sketches and runs to over 100 KB, so snapshot fills in one the
+// caller keeps (off the stack) rather than returning it.
+class StatsAggregator {
+    public:
+        StatsAggregator();
+        ~StatsAggregator();
+
+        StatsShard* add_shard();
+        void snapshot(stats_totals& totals);
+        int shard_count();
+
+    private:
+        std::atomic<StatsShard*> shards[MAX_STATS_SHARDS];
+        void* storage[MAX_STATS_SHARDS];
+        std::atomic<int> count;
+};
+
+#endif // STATSAGGREGATOR_H
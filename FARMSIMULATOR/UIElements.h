@@ -3,71 +3,115 @@
 
 #include "UIEngine.h"
 #include "GameState.h"
+#include "PerfCounters.h"
+#include <algorithm>
 #include <cstdlib>
+#include <cstdio>
+#ifdef PREBUILD_THREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 // #include "constants.h"
 
 // most of the stuff in this file was written by Thomas
 
+// all of the globals below are thread_local so that each thread can be 
+// running a different session (see UISession at the bottom of this file)
+// for the normal single-threaded game this makes no difference
+
 // global pointer to state of current game
-GameState* G = new GameState(0);
+thread_local GameState* G = nullptr;
 
 // global root element
-UIElement* Screen = new UIElement;
+thread_local UIElement* Screen = nullptr;
 
 // global pointers to other elements
+// pages and panels are lazy handles (see LazyPage in UIEngine.h), built the
+// first time they're switched to, so startup only pays for the main menu
 // menu pages
-UIElement* MainMenu;
-UIElement* CreditsPage;
-UIElement* InstructionsPage;
+thread_local LazyPage MainMenu;
+thread_local LazyPage CreditsPage;
+thread_local LazyPage InstructionsPage;
 
 // game pages
-UIElement* DifficultySelection;
-UIElement* GameMenu;
+thread_local LazyPage DifficultySelection;
+thread_local LazyPage GameMenu;
 
 // sub-panels for game menu
-UIElement* TopBar;
-UIElement* HomePanel;
-UIElement* PlotsPanel;
+thread_local LazyPage TopBar;
+thread_local LazyPage HomePanel;
+thread_local LazyPage PlotsPanel;
 
 // transition screen between in-game days
-UIElement* DayTransitionScreen;
+thread_local LazyPage DayTransitionScreen;
 
 // screen to display random events that occurred between in-game days
-UIElement* EventsScreen;
+thread_local UIElement* EventsScreen;
 
 // end screen, to be shown when player loses
-UIElement* GameOverScreen;
+thread_local LazyPage GameOverScreen;
 
-// individual plot elements shown in plots panel
-RectangleElement* PlotElements[NUMBER_OF_PLOTS];
+// individual plot elements shown in plots panel, only set once the plots
+// panel has been built
+thread_local RectangleElement* PlotElements[NUMBER_OF_PLOTS];
 
 // contents of plot panel changes depending on whether player is planting crops
 // or just viewing the plots
-UIElement* PlotsPanelContext;
+thread_local UIElement* PlotsPanelContext;
+
+// statistics and history pages, rebuilt every time they're opened - the
+// last one built is kept here so it can be discarded when the next one
+// replaces it
+thread_local UIElement* StatisticsPage;
+thread_local UIElement* HistoryPage;
 
 // keep track of currently-displayed menu page
-UIElement* CurrentPage;
+thread_local UIElement* CurrentPage;
 
 // keep track of currently-displayed in-game menu panel
-UIElement* CurrentGamePanel;
+thread_local UIElement* CurrentGamePanel;
 
 // keep track of which crop, if any, to plant on the plots panel
-crop_type* CropToPlant = nullptr;
+thread_local crop_type* CropToPlant = nullptr;
+
+// the next day's news and plots, built while the day transition screen is up,
+// on the session's worker thread or in the game's idle loop (see prebuildNextDay)
+struct next_day_build_raw {
+    UIElement eventsScreen;
+    bool plotsBuilt;
+    std::vector<RectangleElement> plots;
+    UIElement plotsContext;
+} typedef next_day_build;
+// started the first time a day ends, then kept for the rest of the session
+class NextDayWorker;
+thread_local NextDayWorker* DayWorker = nullptr;
 
 // prototypes for element intialization functions
 // backgrounds
-UIElement* getBackground1();
 UIElement* getBackground2();
 
 // helpers for standard menu elements
 RectangleElement* getStandardTitle(int x, int y, int w, stringT label);
-RectangleElement* getStandardButton(int x, int y, int w, stringT label, std::function<void()> handler);
+// ownLabel hands a label from malloc over to the button to free
+RectangleElement* getStandardButton(int x, int y, int w, stringT label, ClickHandler handler, bool ownLabel = false);
+
+// click handlers for static pages, which need plain functions
+void goToMainMenu();
+void goToDifficultySelection();
+void goToInstructions();
+void goToStatistics();
+void goToHistory();
+void goToCredits();
+void startNormalGame();
+void startChaosGame();
 
 // menu pages
 UIElement* getMainMenu();
 UIElement* getCreditsPage();
 UIElement* getStatisticsPage();
+UIElement* getHistoryPage();
 UIElement* getInstructionsPage();
 
 // game pages
@@ -96,8 +140,20 @@ UIElement* getGameOverScreen();
 // these elements will be re-initialized often so this function returns a value 
 // instead of a pointer to make memory management easier
 RectangleElement getPlotElement(int index);
-// helper function to keep plots panel reflective of internal data
+// helper functions to keep plots panel reflective of internal data
+void updatePlot(int index);
 void updatePlots();
+// build the events screen and updated plots in the background after a new
+// day starts, and swap them in once they're needed
+void prebuildNextDay();
+void applyNextDay();
+// drop a prebuilt day that won't be used, waiting for it if it's running
+void cancelNextDay();
+// build the day prebuildNextDay asked for when there's no worker thread,
+// for idle time, returns false if there's nothing to build
+bool buildNextDayIdle();
+// stop prebuilding for good, freeing the worker and anything it left behind
+void stopNextDay();
 
 // contextual UI subpanels for plots panel
 UIElement getPlotsPanelPlantMode();
@@ -112,6 +168,8 @@ void playGame(int diff);
 void switchToPage(UIElement* page);
 // helper function to switch between in-game UI panels
 void switchToPanel(UIElement* panel);
+// build one page that hasn't been used yet, for idle time
+bool prewarmUI();
 
 // entity graphics
 CircleElement* getCoinSprite(int x, int y);
@@ -122,46 +180,52 @@ UIElement* getLettuceSprite(int x, int y);
 
 // function to initialize global element pointers
 void initUI() {
-    MainMenu = getMainMenu();
-    CreditsPage = getCreditsPage();
-    InstructionsPage = getInstructionsPage();
+    G = new GameState(0);
+    Screen = new UIElement;
+
+    // pages are only built when first used
+    MainMenu.reset(getMainMenu);
+    CreditsPage.reset(getCreditsPage);
+    InstructionsPage.reset(getInstructionsPage);
 
-    DifficultySelection = getDifficultySelection();
+    DifficultySelection.reset(getDifficultySelection);
 
-    TopBar = getTopBar();
-    HomePanel = getHomePanel();
+    TopBar.reset(getTopBar);
+    HomePanel.reset(getHomePanel);
 
     PlotsPanelContext = new UIElement;
-    PlotsPanel = getPlotsPanel();
+    for (int index = 0; index < NUMBER_OF_PLOTS; ++index) PlotElements[index] = nullptr;
+    PlotsPanel.reset(getPlotsPanel);
 
-    DayTransitionScreen = getDayTransition();
+    DayTransitionScreen.reset(getDayTransition);
     EventsScreen = new UIElement;
-    GameOverScreen = getGameOverScreen();
+    GameOverScreen.reset(getGameOverScreen);
 
-    GameMenu = getGameMenu();
+    GameMenu.reset(getGameMenu);
 
+    StatisticsPage = nullptr;
+    HistoryPage = nullptr;
     CurrentPage = nullptr;
-    CurrentGamePanel = new UIElement;
+    // set by the first switchToPanel
+    CurrentGamePanel = nullptr;
+    // a worker left over from an earlier initUI would be building for a
+    // tree that's gone
+    stopNextDay();
 }
 
-// definitions for element intialization functions
-// background used for menus
-UIElement* getBackground1() {
-    UIElement* bg = new UIElement;
-    // draw scene involving a tractor on a grassy field under a blue sky
-    bg->addChild(new RectangleElement(0, 0, 320, 120, LCD.Blue));
-    bg->addChild(new RectangleElement(0, 120, 320, 120, LCD.Green));
-    bg->addChild(new RectangleElement(200, 140, 80, 40, LCD.Red));
-    bg->addChild(new RectangleElement(240, 100, 40, 40, LCD.Black));
-    bg->addChild(new RectangleElement(246, 106, 28, 28, LCD.White));
-    bg->addChild(new RectangleElement(200, 150, 10, 20, LCD.Gray));
-    bg->addChild(new CircleElement(205, 180, 20, LCD.Black));
-    bg->addChild(new CircleElement(270, 175, 25, LCD.Black));
-    bg->addChild(new CircleElement(205, 180, 8, LCD.Gray));
-    bg->addChild(new CircleElement(270, 175, 10, LCD.Gray));
-    return bg;
+// build the next page that hasn't been used yet, roughly in the order a
+// player reaches them, returns false once everything is built
+bool prewarmUI() {
+    LazyPage* pages[] = {&DifficultySelection, &TopBar, &GameMenu, &HomePanel, &PlotsPanel,
+                         &DayTransitionScreen, &GameOverScreen, &InstructionsPage, &CreditsPage};
+    for (LazyPage* page : pages) {
+        if (page->prewarm()) return true;
+    }
+    return false;
 }
 
+// definitions for element intialization functions
+// background used for menus
 UIElement* getBackground2() {
     UIElement* bg = new UIElement; 
     // make background green to represent grass 
@@ -188,7 +252,7 @@ RectangleElement* getStandardTitle(int x, int y, int w, stringT label) {
     return titleElement;
 }
 // button
-RectangleElement* getStandardButton(int x, int y, int w, stringT label, std::function<void()> handler) {
+RectangleElement* getStandardButton(int x, int y, int w, stringT label, ClickHandler handler, bool ownLabel) {
     // set standard element parameters
     int h = 30; // title assumed to contain single row of text
     int padding = 8; // pixels between shape border and text
@@ -198,7 +262,9 @@ RectangleElement* getStandardButton(int x, int y, int w, stringT label, std::fun
     // create element pointer
     RectangleElement* buttonElement = new RectangleElement(x, y, w, h, panelColor);
     // add label
-    buttonElement->addChild(new StringElement(x+padding, y+padding, label, textColor));
+    StringElement* labelElement = new StringElement(x+padding, y+padding, label, textColor);
+    if (ownLabel) labelElement->ownString();
+    buttonElement->addChild(labelElement);
     // add click handler
     buttonElement->setClickHandler(handler);
 
@@ -206,108 +272,97 @@ RectangleElement* getStandardButton(int x, int y, int w, stringT label, std::fun
     return buttonElement;
 }
 
-// main menu
-UIElement* getMainMenu() {
-    // create a pointer to the main menu container element
-    UIElement* mainMenu = new UIElement;
-
-    // add a nice background image to the main menu
-    mainMenu->addChild(getBackground1());
-
-    // add title panel to menu
-    mainMenu->addChild(getStandardTitle(20, 20, 190, "Meadow Valley"));
-
-    // add start button
-    mainMenu->addChild(getStandardButton(20, 75, 120, "Start", [] {
-        // on click: go to difficulty selection
-        switchToPage(DifficultySelection);
-    }));
-
-    // add instructions button
-    mainMenu->addChild(getStandardButton(20, 113, 120, "Instructions", [] {
-        // on click: switch to instructions page
-        switchToPage(InstructionsPage);
-    }));
-
-    // add statistics button
-    mainMenu->addChild(getStandardButton(20, 151, 120, "Statistics", [] {
-        // on click: switch to statistics page
-        switchToPage(getStatisticsPage());
-    }));
+// static versions of the standard title and button, for StaticPage tables
+constexpr StaticItem staticTitle(int x, int y, int w, stringT label) {
+    return staticLabel(x, y, w, 44, FEHLCD::Scarlet, label, FEHLCD::White, 15, nullptr);
+}
+constexpr StaticItem staticButton(int x, int y, int w, stringT label, void (*handler)(), colorT panelColor = FEHLCD::Gray) {
+    return staticLabel(x, y, w, 30, panelColor, label, FEHLCD::White, 8, handler);
+}
 
-    // add credits button
-    mainMenu->addChild(getStandardButton(20, 189, 120, "Credits", [] {
-        // on click: switch to credits page
-        switchToPage(CreditsPage);
-    }));
+// background used for menus
+// draw scene involving a tractor on a grassy field under a blue sky
+constexpr StaticItem background1[] = {
+    staticRect(0, 0, 320, 120, FEHLCD::Blue, FEHLCD::Blue),
+    staticRect(0, 120, 320, 120, FEHLCD::Green, FEHLCD::Green),
+    staticRect(200, 140, 80, 40, FEHLCD::Red, FEHLCD::Red),
+    staticRect(240, 100, 40, 40, FEHLCD::Black, FEHLCD::Black),
+    staticRect(246, 106, 28, 28, FEHLCD::White, FEHLCD::White),
+    staticRect(200, 150, 10, 20, FEHLCD::Gray, FEHLCD::Gray),
+    staticCircle(205, 180, 20, FEHLCD::Black, FEHLCD::Black),
+    staticCircle(270, 175, 25, FEHLCD::Black, FEHLCD::Black),
+    staticCircle(205, 180, 8, FEHLCD::Gray, FEHLCD::Gray),
+    staticCircle(270, 175, 10, FEHLCD::Gray, FEHLCD::Gray)
+};
 
-    // return the menu element pointer
-    return mainMenu;
+// main menu
+constexpr StaticItem mainMenuItems[] = {
+    // a nice background image and the title panel
+    staticGroup(background1),
+    staticTitle(20, 20, 190, "Meadow Valley"),
+
+    // buttons for each of the other menu pages
+    staticButton(20, 75, 120, "Start", goToDifficultySelection),
+    staticButton(20, 113, 120, "Instructions", goToInstructions),
+    staticButton(20, 151, 120, "Statistics", goToStatistics),
+    staticButton(20, 189, 120, "Credits", goToCredits)
+};
+UIElement* getMainMenu() {
+    return new StaticPage(mainMenuItems);
 }
 // credits page
+constexpr StaticItem creditsItems[] = {
+    staticGroup(background1),
+    staticTitle(20, 20, 280, "Credits"),
+
+    // body
+    staticRect(20, 73, 280, 110, FEHLCD::Black, FEHLCD::Black),
+    staticText(30, 85, "Drew Ripberger - Data/Game State", FEHLCD::White),
+    staticText(30, 120, "Annie Getts - Data/Game State", FEHLCD::White),
+    staticText(30, 155, "Thomas Li - UI Elements", FEHLCD::White),
+
+    staticButton(20, 190, 120, "Return", goToMainMenu)
+};
 UIElement* getCreditsPage() {
-    // create pointer to element container
-    UIElement* creditsPage = new UIElement;
-
-    // add background
-    creditsPage->addChild(getBackground1());
-
-    // add title element
-    creditsPage->addChild(getStandardTitle(20, 20, 280, "Credits"));
-
-    // add body
-    creditsPage->addChild(new RectangleElement(20, 73, 280, 110, LCD.Black));
-    creditsPage->addChild(new StringElement(30, 85, "Drew Ripberger - Data/Game State", LCD.White));
-    creditsPage->addChild(new StringElement(30, 120, "Annie Getts - Data/Game State", LCD.White));
-    creditsPage->addChild(new StringElement(30, 155, "Thomas Li - UI Elements", LCD.White));
-
-    // add return button
-    creditsPage->addChild(getStandardButton(20, 190, 120, "Return", [] {
-        switchToPage(MainMenu);
-    }));
-
-    // return element pointer
-    return creditsPage;
+    return new StaticPage(creditsItems);
 }
 // instructions page
+constexpr StaticItem instructionsItems[] = {
+    staticGroup(background1),
+    staticTitle(20, 20, 280, "Instructions"),
+
+    // body
+    staticRect(20, 73, 280, 110, FEHLCD::Black, FEHLCD::Black),
+    staticText(30, 85, "Welcome to your farm! Buy &", FEHLCD::White),
+    staticText(30, 102, "plant seeds, watch them grow,", FEHLCD::White),
+    staticText(30, 119, "sell the produce, and repeat!", FEHLCD::White),
+    staticText(30, 136, "Each day brings new twists!", FEHLCD::White),
+
+    staticButton(20, 190, 120, "Return", goToMainMenu)
+};
 UIElement* getInstructionsPage() {
-    // create element pointer
-    UIElement* instructionsPage = new UIElement;
-
-    // add background
-    instructionsPage->addChild(getBackground1());
-
-    // add title element
-    instructionsPage->addChild(getStandardTitle(20, 20, 280, "Instructions"));
-
-    // add body
-    instructionsPage->addChild(new RectangleElement(20, 73, 280, 110, LCD.Black));
-    instructionsPage->addChild(new StringElement(30, 85, "Welcome to your farm! Buy &", LCD.White));
-    instructionsPage->addChild(new StringElement(30, 102, "plant seeds, watch them grow,", LCD.White));
-    instructionsPage->addChild(new StringElement(30, 119, "sell the produce, and repeat!", LCD.White));
-    instructionsPage->addChild(new StringElement(30, 136, "Each day brings new twists!", LCD.White));
-
-    // add return button
-    instructionsPage->addChild(getStandardButton(20, 190, 120, "Return", [] {
-        switchToPage(MainMenu);
-    }));
-
-    // return element pointer
-    return instructionsPage;
+    return new StaticPage(instructionsItems);
 }
 // statistics page
+// the labels are static, the values are added as dynamic children since
+// they change after every game
+constexpr StaticItem statisticsItems[] = {
+    staticGroup(background1),
+    staticTitle(20, 20, 280, "Statistics"),
+
+    // body
+    staticRect(20, 73, 280, 110, FEHLCD::Black, FEHLCD::Black),
+    staticText(30, 85, "Max Days Survived: ", FEHLCD::White),
+    staticText(30, 102, "Total Money Earned: ", FEHLCD::White),
+    staticText(30, 119, "Total Money Lost: ", FEHLCD::White),
+    staticText(30, 136, "Carrots Planted: ", FEHLCD::White),
+
+    staticButton(20, 190, 120, "Return", goToMainMenu),
+    staticButton(180, 190, 120, "History", goToHistory)
+};
 UIElement* getStatisticsPage() {
     // create element pointer
-    UIElement* statisticsPage = new UIElement;
-
-    // add background
-    statisticsPage->addChild(getBackground1());
-
-    // add title element
-    statisticsPage->addChild(getStandardTitle(20, 20, 280, "Statistics"));
-
-    // add body
-    statisticsPage->addChild(new RectangleElement(20, 73, 280, 110, LCD.Black));
+    UIElement* statisticsPage = new StaticPage(statisticsItems);
 
     stats game_stats = G->get_game_stats();
 
@@ -316,61 +371,92 @@ UIElement* getStatisticsPage() {
     int total_lost = game_stats.total_money_lost;
     int total_carrots = game_stats.carrots_planted;
 
-
-    statisticsPage->addChild(new StringElement(30, 85, "Max Days Survived: ", LCD.White));
     statisticsPage->addChild(new ValueElement(220, 85, [max_days](){return max_days;}, LCD.White));
-
-    statisticsPage->addChild(new StringElement(30, 102, "Total Money Earned: ", LCD.White));
     statisticsPage->addChild(new ValueElement(220, 102, [total_earned](){return total_earned;}, LCD.White));
-
-    statisticsPage->addChild(new StringElement(30, 119, "Total Money Lost: ", LCD.White));
     statisticsPage->addChild(new ValueElement(220, 119, [total_lost](){return total_lost;}, LCD.White));
-
-    statisticsPage->addChild(new StringElement(30, 136, "Carrots Planted: ", LCD.White));
     statisticsPage->addChild(new ValueElement(220, 136, [total_carrots](){return total_carrots;}, LCD.White));
 
-    // add return button
-    statisticsPage->addChild(getStandardButton(20, 190, 120, "Return", [] {
-        switchToPage(MainMenu);
-    }));
-
     // return element pointer
     return statisticsPage;
 }
-// difficulty selection
-UIElement* getDifficultySelection() {
-    // initialize element pointer
-    UIElement* difficultySelection = new UIElement;
-
-    // set background
-    difficultySelection->addChild(getBackground1());
-
-    // add title text
-    difficultySelection->addChild(getStandardTitle(20, 20, 280, "Select a Difficulty Level"));
+// history page, charting the coins at the end of each of the last days of
+// the current (or last) game, red on days with a bad event
+constexpr StaticItem historyItems[] = {
+    staticGroup(background1),
+    staticTitle(20, 20, 280, "History"),
+
+    // body, the chart goes on top
+    staticRect(20, 73, 280, 110, FEHLCD::Black, FEHLCD::Black),
+    staticText(30, 80, "Peak coins:", FEHLCD::White),
+
+    staticButton(20, 190, 120, "Return", goToStatistics)
+};
+UIElement* getHistoryPage() {
+    // one bar per day across the body
+    const int chartDays = 26, barX = 30, barStep = 10, barWidth = 8;
+    const int chartBottom = 176, chartHeight = 76;
+
+    UIElement* historyPage = new StaticPage(historyItems);
+
+    day_record days[chartDays];
+    int count = G->history.last_days(days, chartDays);
+    if (count == 0) {
+        historyPage->addChild(new StringElement(30, 120, "No days played yet", LCD.White));
+        return historyPage;
+    }
 
-    // add buttons
-    RectangleElement* normalModeButton = getStandardButton(20, 90, 280, "Normal Mode", [] {
-        // on click: set game difficulty to normal mode, start game
-        playGame(0);
-    });
-    normalModeButton->setColor(LCD.Black);
-    difficultySelection->addChild(normalModeButton);
+    int peak = 0;
+    for (int i = 0; i < count; ++i) {
+        if (days[i].coins > peak) peak = days[i].coins;
+    }
+    historyPage->addChild(new ValueElement(174, 80, [peak]() { return peak; }, LCD.White));
+
+    for (int i = 0; i < count; ++i) {
+        int h = peak > 0 ? (int) ((long long) days[i].coins * chartHeight / peak) : 0;
+        if (h < 1) h = 1;
+        bool badDay = false;
+        for (int e = 0; e < 10; ++e) {
+            if ((days[i].events & (1 << e)) && G->events[e].isPenalty) badDay = true;
+        }
+        historyPage->addChild(new RectangleElement(barX + i * barStep, chartBottom - h, barWidth, h,
+                                                   badDay ? LCD.Red : LCD.Green));
+    }
 
-    RectangleElement* chaosModeButton = getStandardButton(20, 130, 280, "Chaos Mode", [] {
-        // on click: set game difficulty to chaos mode, start game
-        playGame(1);
-    });
-    chaosModeButton->setColor(LCD.Black);
-    difficultySelection->addChild(chaosModeButton);
+    return historyPage;
+}
+// difficulty selection page
+constexpr StaticItem difficultyItems[] = {
+    staticGroup(background1),
+    staticTitle(20, 20, 280, "Select a Difficulty Level"),
 
-    difficultySelection->addChild(getStandardButton(20, 190, 120, "Return", [] {
-        // on click: return to main menu
-        switchToPage(MainMenu);
-    }));
+    // mode buttons are black instead of the usual gray
+    staticButton(20, 90, 280, "Normal Mode", startNormalGame, FEHLCD::Black),
+    staticButton(20, 130, 280, "Chaos Mode", startChaosGame, FEHLCD::Black),
 
-    // return element pointer
-    return difficultySelection;
+    staticButton(20, 190, 120, "Return", goToMainMenu)
+};
+UIElement* getDifficultySelection() {
+    return new StaticPage(difficultyItems);
+}
+// static page click handlers
+void goToMainMenu() { switchToPage(MainMenu); }
+void goToDifficultySelection() { switchToPage(DifficultySelection); }
+void goToInstructions() { switchToPage(InstructionsPage); }
+void goToStatistics() {
+    // the numbers change after every game, so the page is built fresh
+    if (StatisticsPage) StatisticsPage->discard();
+    StatisticsPage = getStatisticsPage();
+    switchToPage(StatisticsPage);
+}
+void goToHistory() {
+    if (HistoryPage) HistoryPage->discard();
+    HistoryPage = getHistoryPage();
+    switchToPage(HistoryPage);
 }
+void goToCredits() { switchToPage(CreditsPage); }
+// set game difficulty and start game
+void startNormalGame() { playGame(0); }
+void startChaosGame() { playGame(1); }
 // game menu
 UIElement* getGameMenu() {
     // initialize element pointer
@@ -420,7 +506,7 @@ UIElement* getTopBar() {
         // on click: start procedure for moving to next day
         if (G->coins > 0) {
             G->new_day();
-            updatePlots();
+            prebuildNextDay();
             switchToPage(DayTransitionScreen);
         }
     }));
@@ -469,9 +555,10 @@ UIElement* getPlotsPanel() {
         plotsPanel->addChild(PlotElements[index]);
     }
 
-    // add contextual subpanel
+    // add contextual subpanel, which is already in plant mode if the panel
+    // is first built to plant a crop
     plotsPanel->addChild(PlotsPanelContext);
-    *PlotsPanelContext = getPlotsPanelViewMode();
+    *PlotsPanelContext = CropToPlant ? getPlotsPanelPlantMode() : getPlotsPanelViewMode();
 
     // return element pointer
     return plotsPanel;
@@ -502,10 +589,11 @@ UIElement getPlotsPanelViewMode() {
 
     // add button to harvest crops
     subpanel.addChild(getStandardButton(15, 55, 150, "Harvest Crops", [] {
-        // on click: harvest and sell crops that are fully-grown, update plots and game state as needed
-        for (int index = 0; index < NUMBER_OF_PLOTS; ++index) {
-            G->harvest(&(G->plots[index]));
-            updatePlots();
+        // on click: harvest and sell crops that are fully-grown, then redraw
+        // only the plots that were harvested
+        harvest_delta delta = G->harvest_all();
+        for (int i = 0; i < (int) delta.changed.size(); ++i) {
+            if (delta.changed[i] < NUMBER_OF_PLOTS) updatePlot(delta.changed[i]);
         }
     }));
 
@@ -515,6 +603,19 @@ UIElement getPlotsPanelViewMode() {
         switchToPanel(HomePanel);
     }));
 
+#ifdef DEBUG_CONTROLS
+    // debug only: skip ahead without clicking through every day
+    // (build with make GAMEFLAGS=-DDEBUG_CONTROLS)
+    subpanel.addChild(getStandardButton(15, 205, 150, "Skip 10 Days", [] {
+        // on click: simulate 10 days with auto-harvest, then rebuild the UI once
+        G->fast_forward(10, FF_HARVEST);
+        updatePlots();
+        if (G->coins <= 0) {
+            switchToPage(GameOverScreen);
+        }
+    }));
+#endif
+
     return subpanel;
 }
 // individual plots
@@ -533,7 +634,7 @@ RectangleElement getPlotElement(int index) {
         colorT textColor = LCD.White;
 
         // show indicator for crop type
-        UIElement* cropSprite = new UIElement;
+        UIElement* cropSprite = nullptr;
         switch (G->plots[index].type.crop_id) {
         case 1:
             cropSprite = getCarrotSprite(plotX+5, plotY+5);
@@ -551,14 +652,16 @@ RectangleElement getPlotElement(int index) {
         default:
             break;
         }
-        plotElement.addChild(cropSprite);
+        if (cropSprite) plotElement.addChild(cropSprite);
 
-        // show indicator for remaining days
-        char* tempStr = (char*) malloc(sizeof(char) * 3);
-        int daysLeft = G->plots[index].type.grow_time - G->plots[index].days_active;
-        if (daysLeft < 0) daysLeft = 0;
-        sprintf(tempStr, "%dd", daysLeft);
-        plotElement.addChild(new StringElement(plotX+10, plotY+16, tempStr, textColor));
+        // show indicator for remaining days (grow times come from the
+        // game config, so this has room for any int)
+        char* tempStr = (char*) malloc(sizeof(char) * 16);
+        int daysLeft = G->days_left(index);
+        snprintf(tempStr, 16, "%dd", daysLeft);
+        StringElement* daysText = new StringElement(plotX+10, plotY+16, tempStr, textColor);
+        daysText->ownString();
+        plotElement.addChild(daysText);
 
         
     }
@@ -568,6 +671,7 @@ RectangleElement getPlotElement(int index) {
         plotElement.setClickHandler([index] {
             // on click: plant selected crop type in plot, update UI to reflect change, return to home panel
             G->plant(&(G->plots[index]), CropToPlant);
+            free(CropToPlant);
             CropToPlant = nullptr;
             updatePlots();
             switchToPanel(HomePanel);
@@ -579,6 +683,11 @@ RectangleElement getPlotElement(int index) {
 }
 // re-initialize plot elements to account for changes in internal data
 void updatePlots() {
+    // nothing to update until the plots panel is built, and it'll be built
+    // from the current state
+    if (!PlotsPanel.built()) return;
+    PERF_REGION(perf, "updatePlots");
+    PERF_ITEMS(perf, NUMBER_OF_PLOTS);
     if (CropToPlant) {
         *PlotsPanelContext = getPlotsPanelPlantMode();
     }
@@ -586,13 +695,18 @@ void updatePlots() {
         *PlotsPanelContext = getPlotsPanelViewMode();
     }
     for (int index = 0; index < NUMBER_OF_PLOTS; ++index) {
-        *PlotElements[index] = getPlotElement(index);
+        updatePlot(index);
     }
 }
+// re-initialize a single plot element
+void updatePlot(int index) {
+    if (!PlotsPanel.built()) return;
+    *PlotElements[index] = getPlotElement(index);
+}
 // listings for crops in home panel
 RectangleElement* getCropListing(int x, int y, const crop_type* cropInfo, UIElement* (*spriteFunction)(int, int)) {
-    // for storing int values in cstring
-    char* tempStr = (char*) malloc(sizeof(char) * 16);
+    // for storing int values in cstring, room for any two ints
+    char* tempStr = (char*) malloc(sizeof(char) * 32);
 
     // create element container
     RectangleElement* cropListing = new RectangleElement(x, y, 300, 35, LCD.Black, LCD.White);
@@ -604,22 +718,25 @@ RectangleElement* getCropListing(int x, int y, const crop_type* cropInfo, UIElem
     cropListing->addChild(new StringElement(x+35, y+10, cropInfo->name, LCD.White));
 
     // list grow time and sell price
-    sprintf(tempStr, "(%dd,    %d)", cropInfo->grow_time, cropInfo->sale_price);
-    cropListing->addChild(new StringElement(x+100, y+10, tempStr, LCD.White));
+    snprintf(tempStr, 32, "(%dd,    %d)", cropInfo->grow_time, cropInfo->sale_price);
+    StringElement* details = new StringElement(x+100, y+10, tempStr, LCD.White);
+    details->ownString();
+    cropListing->addChild(details);
     cropListing->addChild(getCoinSprite(x+130, y+9));
 
     // show button for planting crops
-    tempStr = (char*) malloc(sizeof(char) * 16);
-    sprintf(tempStr, "Plant (    %d)", cropInfo->seed_price);
+    tempStr = (char*) malloc(sizeof(char) * 32);
+    snprintf(tempStr, 32, "Plant (    %d)", cropInfo->seed_price);
     cropListing->addChild(getStandardButton(x+190, y+2, 105, tempStr, [cropInfo] {
         // on click: allow user to plant crop in plots if they can afford it
         if (cropInfo->seed_price <= G->coins) {
+            free(CropToPlant);
             CropToPlant = (crop_type*) malloc(sizeof(crop_type));
             *CropToPlant = *cropInfo;
             updatePlots();
             switchToPanel(PlotsPanel);
         }
-    }));
+    }, true));
     cropListing->addChild(getCoinSprite(x+245, y+9));
 
     return cropListing;
@@ -634,7 +751,7 @@ UIElement* getDayTransition() {
     RectangleElement* bg = new RectangleElement(0, 0, 320, 240, LCD.Black);
     // exit transition screen and start new day when background clicked
     bg->setClickHandler([] {
-        *EventsScreen = getEventsScreen();
+        applyNextDay();
         switchToPage(EventsScreen);
     });
     transitionScreen->addChild(bg);
@@ -665,7 +782,7 @@ UIElement getEventsScreen() {
 
     // fill body contents based on which events occurred
     int textX = 20, textY = 74; // keep track of where to write text
-    for (int index = 0; index <= 10; ++index) {
+    for (int index = 0; index < 10; ++index) {
         if (G->event_occurred[index]) {
             eventsScreen.addChild(new StringElement(textX, textY, G->events[index].name, LCD.White));
             eventsScreen.addChild(new StringElement(textX, textY+20, G->events[index].desc, LCD.White));
@@ -786,6 +903,8 @@ UIElement* getLettuceSprite(int x, int y) {
 
 // switch between pages
 void switchToPage(UIElement* page) {
+    // the prebuilt day is only wanted if the transition screen is up
+    if (page != DayTransitionScreen) cancelNextDay();
     if (CurrentPage) Screen->removeChild(CurrentPage);
     Screen->addChild(page);
     CurrentPage = page;
@@ -799,7 +918,8 @@ void switchToPanel(UIElement* panel) {
 }
 
 void playGame(int diff) {
-    // initialize game state
+    // initialize game state, once nothing is reading the old one
+    cancelNextDay();
     *G = GameState(diff);
 
     switchToPage(GameMenu); // go to game menu
@@ -807,4 +927,353 @@ void playGame(int diff) {
     updatePlots();
 }
 
+/*
+UISession
+Bundles up every UI global above so that one process can host many 
+independent games. newSession builds a complete fresh element tree and game 
+state without disturbing whatever session the calling thread is currently 
+running. To work with a session, loadSession copies its pointers into this 
+thread's globals, and saveSession copies them back afterwards (the globals 
+can change while handling clicks, e.g. CurrentPage). A session must only be 
+loaded on one thread at a time. deleteSession frees a session and everything
+it built once it's no longer needed.
+*/
+struct UISession {
+    GameState* G;
+    UIElement* Screen;
+    LazyPage MainMenu;
+    LazyPage CreditsPage;
+    LazyPage InstructionsPage;
+    LazyPage DifficultySelection;
+    LazyPage GameMenu;
+    LazyPage TopBar;
+    LazyPage HomePanel;
+    LazyPage PlotsPanel;
+    LazyPage DayTransitionScreen;
+    UIElement* EventsScreen;
+    LazyPage GameOverScreen;
+    RectangleElement* PlotElements[NUMBER_OF_PLOTS];
+    UIElement* PlotsPanelContext;
+    UIElement* StatisticsPage;
+    UIElement* HistoryPage;
+    UIElement* CurrentPage;
+    UIElement* CurrentGamePanel;
+    crop_type* CropToPlant;
+    NextDayWorker* DayWorker;
+};
+
+void saveSession(UISession* s) {
+    s->G = G;
+    s->Screen = Screen;
+    s->MainMenu = MainMenu;
+    s->CreditsPage = CreditsPage;
+    s->InstructionsPage = InstructionsPage;
+    s->DifficultySelection = DifficultySelection;
+    s->GameMenu = GameMenu;
+    s->TopBar = TopBar;
+    s->HomePanel = HomePanel;
+    s->PlotsPanel = PlotsPanel;
+    s->DayTransitionScreen = DayTransitionScreen;
+    s->EventsScreen = EventsScreen;
+    s->GameOverScreen = GameOverScreen;
+    for (int i = 0; i < NUMBER_OF_PLOTS; ++i) s->PlotElements[i] = PlotElements[i];
+    s->PlotsPanelContext = PlotsPanelContext;
+    s->StatisticsPage = StatisticsPage;
+    s->HistoryPage = HistoryPage;
+    s->CurrentPage = CurrentPage;
+    s->CurrentGamePanel = CurrentGamePanel;
+    s->CropToPlant = CropToPlant;
+    s->DayWorker = DayWorker;
+}
+
+void loadSession(const UISession* s) {
+    G = s->G;
+    Screen = s->Screen;
+    MainMenu = s->MainMenu;
+    CreditsPage = s->CreditsPage;
+    InstructionsPage = s->InstructionsPage;
+    DifficultySelection = s->DifficultySelection;
+    GameMenu = s->GameMenu;
+    TopBar = s->TopBar;
+    HomePanel = s->HomePanel;
+    PlotsPanel = s->PlotsPanel;
+    DayTransitionScreen = s->DayTransitionScreen;
+    EventsScreen = s->EventsScreen;
+    GameOverScreen = s->GameOverScreen;
+    for (int i = 0; i < NUMBER_OF_PLOTS; ++i) PlotElements[i] = s->PlotElements[i];
+    PlotsPanelContext = s->PlotsPanelContext;
+    StatisticsPage = s->StatisticsPage;
+    HistoryPage = s->HistoryPage;
+    CurrentPage = s->CurrentPage;
+    CurrentGamePanel = s->CurrentGamePanel;
+    CropToPlant = s->CropToPlant;
+    DayWorker = s->DayWorker;
+}
+
+UISession* newSession() {
+    // keep whatever this thread was doing
+    UISession previous;
+    saveSession(&previous);
+
+    // build a fresh tree, starting on the main menu like main.cpp does
+    UISession* session = new UISession;
+    CropToPlant = nullptr;
+    // the previous session's worker is still its own
+    DayWorker = nullptr;
+    initUI();
+    switchToPage(MainMenu);
+    saveSession(session);
+
+    loadSession(&previous);
+    return session;
+}
+
+// background building for the day transition (see next_day_build at the
+// top of this file), down here since it needs UISession
+
+// same as updatePlots and the events screen rebuild in applyNextDay, but
+// into new elements instead of the live tree
+next_day_build buildNextDay() {
+    next_day_build build;
+    build.plotsBuilt = PlotsPanel.built();
+    if (build.plotsBuilt) {
+        for (int index = 0; index < NUMBER_OF_PLOTS; ++index) {
+            build.plots.push_back(getPlotElement(index));
+        }
+        build.plotsContext = CropToPlant ? getPlotsPanelPlantMode() : getPlotsPanelViewMode();
+    }
+    build.eventsScreen = getEventsScreen();
+    return build;
+}
+// throw away a finished build that won't be used
+void dropNextDay(next_day_build& build) {
+    // assigning over the elements discards their children, which just
+    // destroying them wouldn't
+    for (RectangleElement& plot : build.plots) plot = RectangleElement(0, 0, 0, 0);
+    build = next_day_build();
+}
+
+#ifdef PREBUILD_THREAD
+/*
+NextDayWorker
+One thread per session that builds the next day while the transition screen
+is up. It is started the first time a day ends and then sleeps between days,
+so ending a day only costs a handoff rather than a new thread. Only tools
+are built with PREBUILD_THREAD; the game uses the version below instead,
+which builds from its idle loop, so it doesn't need threads at all.
+
+The worker gets a copy of the session's globals and only reads the game
+state, but that still means nothing may change the game state while a
+build is pending - which is why switchToPage and playGame cancel it first.
+*/
+class NextDayWorker {
+    public:
+        NextDayWorker() : requested(false), building(false), ready(false), stopping(false) {
+            thread = std::thread(&NextDayWorker::run, this);
+        }
+        // throws away whatever build is pending, then stops the thread
+        ~NextDayWorker() {
+            std::unique_lock<std::mutex> guard(lock);
+            // a build that was asked for but hasn't started yet never will
+            requested = false;
+            // one that's running can't be stopped, so wait for it
+            finished.wait(guard, [this] { return !building; });
+            // and a finished one that nobody took gets freed here, since
+            // result going away with the worker wouldn't free its children
+            if (ready) dropNextDay(result);
+            ready = false;
+            stopping = true;
+            guard.unlock();
+            wake.notify_one();
+            thread.join();
+        }
+
+        // start building for this session, dropping any build not taken yet
+        void start(const UISession& s) {
+            std::unique_lock<std::mutex> guard(lock);
+            finished.wait(guard, [this] { return !building; });
+            if (ready) dropNextDay(result);
+            ready = false;
+            session = s;
+            requested = true;
+            guard.unlock();
+            wake.notify_one();
+        }
+        // wait for the last build started, false if there isn't one
+        bool take(next_day_build& build) {
+            std::unique_lock<std::mutex> guard(lock);
+            if (!requested && !building && !ready) return false;
+            finished.wait(guard, [this] { return ready; });
+            build = std::move(result);
+            ready = false;
+            return true;
+        }
+        void cancel() {
+            std::unique_lock<std::mutex> guard(lock);
+            requested = false;
+            finished.wait(guard, [this] { return !building; });
+            if (ready) dropNextDay(result);
+            ready = false;
+        }
+
+    private:
+        void run() {
+            std::unique_lock<std::mutex> guard(lock);
+            while (true) {
+                wake.wait(guard, [this] { return requested || stopping; });
+                if (stopping) return;
+                requested = false;
+                building = true;
+                loadSession(&session);
+                guard.unlock();
+                next_day_build build = buildNextDay();
+                guard.lock();
+                result = std::move(build);
+                building = false;
+                ready = true;
+                finished.notify_all();
+            }
+        }
+
+        std::thread thread;
+        std::mutex lock;
+        std::condition_variable wake, finished;
+        UISession session;
+        bool requested, building, ready, stopping;
+        next_day_build result;
+};
+#else
+/*
+NextDayWorker
+The game's version of the worker above, without a thread. start only notes
+that a build is wanted, and the idle loop in main.cpp builds it with step
+while the transition screen waits for a tap. It works on the live globals
+rather than a copy, since the game only ever has the one session. If the tap
+comes before the idle loop got to it, take has nothing and applyNextDay
+builds on the tap like it used to.
+*/
+class NextDayWorker {
+    public:
+        NextDayWorker() : requested(false), ready(false) {}
+        // a finished build that nobody took gets freed here, since result
+        // going away with the worker wouldn't free its children
+        ~NextDayWorker() {
+            if (ready) dropNextDay(result);
+        }
+
+        void start(const UISession&) {
+            if (ready) dropNextDay(result);
+            ready = false;
+            requested = true;
+        }
+        // build what start asked for, false if there's nothing to do
+        bool step() {
+            if (!requested) return false;
+            requested = false;
+            result = buildNextDay();
+            ready = true;
+            return true;
+        }
+        bool take(next_day_build& build) {
+            requested = false;
+            if (!ready) return false;
+            build = std::move(result);
+            ready = false;
+            return true;
+        }
+        void cancel() {
+            requested = false;
+            if (ready) dropNextDay(result);
+            ready = false;
+        }
+
+    private:
+        bool requested, ready;
+        next_day_build result;
+};
+#endif
+
+// start building the next day's screens on the session's worker, so the
+// transition screen stays responsive
+void prebuildNextDay() {
+    if (!DayWorker) DayWorker = new NextDayWorker;
+    UISession session;
+    saveSession(&session);
+    DayWorker->start(session);
+}
+// swap in what prebuildNextDay built, waiting for it if it isn't done yet,
+// or build everything right away if nothing was built
+void applyNextDay() {
+    next_day_build build;
+    if (!DayWorker || !DayWorker->take(build)) {
+        updatePlots();
+        *EventsScreen = getEventsScreen();
+        return;
+    }
+
+    // moved rather than copied, so the click handlers don't get copied too
+    if (build.plotsBuilt && PlotsPanel.built()) {
+        for (int index = 0; index < NUMBER_OF_PLOTS; ++index) {
+            *PlotElements[index] = std::move(build.plots[index]);
+        }
+        *PlotsPanelContext = std::move(build.plotsContext);
+    }
+    *EventsScreen = std::move(build.eventsScreen);
+}
+void cancelNextDay() {
+    if (DayWorker) DayWorker->cancel();
+}
+bool buildNextDayIdle() {
+#ifdef PREBUILD_THREAD
+    // the worker thread already does it
+    return false;
+#else
+    return DayWorker && DayWorker->step();
+#endif
+}
+void stopNextDay() {
+    // waits for a build that's running and frees one that's done
+    delete DayWorker;
+    DayWorker = nullptr;
+}
+
+// free everything a session from newSession owns - its game state, every
+// page that got built and its prebuild worker - and then the session itself,
+// without disturbing whatever session the calling thread is running
+void deleteSession(UISession* session) {
+    UISession previous;
+    saveSession(&previous);
+    loadSession(session);
+
+    stopNextDay();
+    // take the pages out of the ones they're shown in, so freeing each page
+    // below doesn't free another one along with it
+    Screen->removeChild(CurrentPage);
+    if (GameMenu.built()) {
+        GameMenu->removeChild(TopBar);
+        GameMenu->removeChild(CurrentGamePanel);
+    }
+    std::vector<UIElement*> roots;
+    LazyPage* pages[] = {&MainMenu, &CreditsPage, &InstructionsPage, &DifficultySelection, &GameMenu,
+                         &TopBar, &HomePanel, &PlotsPanel, &DayTransitionScreen, &GameOverScreen};
+    for (LazyPage* page : pages) {
+        if (page->built()) roots.push_back(page->get());
+    }
+    // the plots panel's context is made up front, but only the panel links it
+    if (!PlotsPanel.built()) roots.push_back(PlotsPanelContext);
+    UIElement* others[] = {Screen, CurrentPage, EventsScreen, StatisticsPage, HistoryPage, CurrentGamePanel};
+    for (UIElement* element : others) {
+        if (element) roots.push_back(element);
+    }
+    // CurrentPage and CurrentGamePanel are usually one of the pages already
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    for (UIElement* root : roots) root->freeMemory();
+    free(CropToPlant);
+    delete G;
+
+    loadSession(&previous);
+    delete session;
+}
+
 #endif // UIElements_H
@@ -2,6 +2,12 @@
 #define UIEngine
 
 #include "UIEngine.h"
+#include "PerfCounters.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 colorT defaultFill = LCD.Black;
 colorT defaultLine = LCD.White;
@@ -11,42 +17,221 @@ Member functions for UIElement
 Written by Thomas Li 
 11/27/2020 
 */
+// every element in the process, whichever thread made it (the next day's
+// screens are built on a worker thread)
+static std::atomic<long> liveElementCount(0);
+
+// elements waiting to be deleted, see discard - each thread's UI has its own
+// queue, and discardedCount includes everything below the queued elements
+static thread_local std::vector<UIElement*> discardQueue;
+static thread_local int discardedCount = 0;
+
+UIElement::UIElement() { ++liveElementCount; }
+UIElement::UIElement(UIElement&& other) {
+    ++liveElementCount;
+    *this = std::move(other);
+}
+UIElement& UIElement::operator=(UIElement&& other) {
+    if (this == &other) return *this;
+    // whatever was here before is replaced, and stays where it is in the tree
+    discardChildren();
+    delete children;
+    clickHandler = other.clickHandler;
+    xPos = other.xPos;
+    yPos = other.yPos;
+    elementType = other.elementType;
+    listenForClick = other.listenForClick;
+    // take over the children, which have to point back at their new parent
+    children = other.children;
+    other.children = nullptr;
+    if (children) {
+        std::vector<UIElement*> moved;
+        children->releaseElements(moved);
+        for (UIElement* child : moved) addChild(child);
+    }
+    return *this;
+}
+UIElement::~UIElement() {
+    // children are freed by whoever frees this element (see freeMemory and
+    // reclaim), only the list itself goes with it
+    --liveElementCount;
+    delete children;
+}
+
 void UIElement::render() {
+    PERF_REGION(perf, "UIElement::render");
     // render element itself, followed by all children
     renderSelf();
-    children->renderElements();
+    if (children) children->renderElements();
+}
+
+// scratch space for renderVisible
+static thread_local CoverageMap coverage;
+static thread_local std::vector<DrawNode> drawList;
+
+// static page items as draw nodes, see the StaticPage helpers further down
+static void collectItems(UIElement* page, const StaticItem* items, int count, std::vector<DrawNode>& list);
+static void getItemBounds(const StaticItem& item, bool label, int* x, int* y, int* w, int* h);
+static void renderItem(const StaticItem& item, bool label);
+
+int UIElement::renderVisible() {
+    PERF_REGION(perf, "UIElement::renderVisible");
+    cullDrawList(drawList);
+
+    // paint in the usual order, jumping over subtrees with nothing visible
+    int count = (int) drawList.size();
+    int drawn = 0;
+    int i = 0;
+    while (i < count) {
+        const DrawNode& node = drawList[i];
+        int after = node.end < count ? drawList[node.end].visibleFrom : 0;
+        if (node.visibleFrom == after) {
+            i = node.end;
+            continue;
+        }
+        if (node.visible) {
+            if (node.item) renderItem(*node.item, node.label);
+            else node.element->renderSelf();
+            ++drawn;
+        }
+        ++i;
+    }
+    PERF_ITEMS(perf, drawn);
+    return drawn;
+}
+void UIElement::cullDrawList(std::vector<DrawNode>& list) {
+    // flatten subtree into paint order
+    list.clear();
+    collectDrawList(list);
+    coverage.clear();
+
+    // walk backwards from the last element painted, checking each element
+    // against the area that opaque elements painted after it will cover
+    int count = (int) list.size();
+    for (int i = count - 1; i >= 0; --i) {
+        DrawNode& node = list[i];
+        int x, y, w, h;
+        if (node.item) {
+            // filled rectangles hide what's behind them, same as elements
+            getItemBounds(*node.item, node.label, &x, &y, &w, &h);
+            node.visible = coverage.reveal(x, y, w, h, !node.label && node.item->kind == STATIC_RECT);
+        }
+        else if (node.element->elementType == ELEMENT_STATIC_PAGE) {
+            // drawn by its item nodes instead
+            node.visible = false;
+        }
+        else {
+            node.visible = node.element->getBounds(&x, &y, &w, &h)
+                        && coverage.reveal(x, y, w, h, node.element->isOpaque());
+        }
+
+        // running count, so that a subtree has something visible if the
+        // count changes between the element and the end of its subtree
+        node.visibleFrom = (i + 1 < count ? list[i + 1].visibleFrom : 0) + node.visible;
+    }
 }
+void CoverageMap::clear() { memset(bits, 0, sizeof(bits)); }
+bool CoverageMap::reveal(int x, int y, int w, int h, bool opaque) {
+    // clip box to screen, boxes fully off screen have nothing to show
+    int x1 = x + w - 1, y1 = y + h - 1;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 >= SCREEN_WIDTH) x1 = SCREEN_WIDTH - 1;
+    if (y1 >= SCREEN_HEIGHT) y1 = SCREEN_HEIGHT - 1;
+    if (x > x1 || y > y1) return false;
+
+    // bits for columns x through x1 in each word of a row
+    uint64_t mask[COVER_WORDS];
+    for (int word = 0; word < COVER_WORDS; ++word) {
+        int lo = word * 64, hi = lo + 63;
+        if (x > hi || x1 < lo) {
+            mask[word] = 0;
+            continue;
+        }
+        int from = (x > lo ? x : lo) - lo, to = (x1 < hi ? x1 : hi) - lo;
+        mask[word] = (to == 63 ? ~0ull : (1ull << (to + 1)) - 1) & ~((1ull << from) - 1);
+    }
+
+    // visible if any pixel is still uncovered
+    bool visible = false;
+    for (int row = y; row <= y1 && !visible; ++row) {
+        for (int word = 0; word < COVER_WORDS; ++word) {
+            if ((bits[row][word] & mask[word]) != mask[word]) {
+                visible = true;
+                break;
+            }
+        }
+    }
+
+    // opaque boxes hide everything painted before them
+    if (visible && opaque) {
+        for (int row = y; row <= y1; ++row) {
+            for (int word = 0; word < COVER_WORDS; ++word) bits[row][word] |= mask[word];
+        }
+    }
+    return visible;
+}
+
+void UIElement::collectDrawList(std::vector<DrawNode>& list) {
+    // element itself, followed by its subtree
+    int index = (int) list.size();
+    DrawNode node;
+    node.element = this;
+    node.item = nullptr;
+    node.label = false;
+    node.end = 0;
+    node.visible = false;
+    node.visibleFrom = 0;
+    list.push_back(node);
+    // a static page's table is drawn before its children
+    if (elementType == ELEMENT_STATIC_PAGE) {
+        StaticPage* page = static_cast<StaticPage*>(this);
+        collectItems(this, page->items, page->count, list);
+    }
+    if (children) children->collectDrawList(list);
+    list[index].end = (int) list.size();
+}
+
 bool UIElement::handleClick(int x, int y) {
+    PERF_REGION(perf, "UIElement::handleClick");
+    // handlers can discard elements, including the one being clicked, so
+    // the discard queue is only ever flushed once the tap on the root of
+    // the tree is done with
+    bool root = !parent;
+    bool clicked = false;
     // check if children were clicked
-    if (children->handleClick(x, y)) {
+    if (children && children->handleClick(x, y)) {
         // terminate callback if any were clicked
-        return true;
+        clicked = true;
     }
     // check if this element itself was clicked
-    if (listenForClick && isClicked(x, y)) {
-        // if clicked, execute the click handler
+    else if (listenForClick && isClicked(x, y)) {
+        // if clicked, execute the click handler (if there is one)
         // and return true to indicate that the element was clicked
-        clickHandler();
-        return true;
+        if (clickHandler) clickHandler();
+        clicked = true;
     }
+    if (root && discardedCount > DiscardLimit) flushDiscarded();
     // return false if nothing was clicked
-    return false;
+    return clicked;
 }
 
-void UIElement::setClickHandler(std::function<void()> func) {
-    clickHandler = func; // assign handler
+void UIElement::setClickHandler(ClickHandler func) {
+    // assign handler
+    clickHandler = func;
     listenForClick = true; // enable click detection
 }
 void UIElement::disableClickHandler() { listenForClick = false; }
 void UIElement::enableClickHandler() { listenForClick = true; }
 
 void UIElement::addChild(UIElement* childPtr) {
+    if (!children) children = new ElementList(); // first child
     children->addElement(childPtr); // add element to child subtree
     childPtr->parent = this; // set parent of child
 }
 void UIElement::removeChild(UIElement* childPtr) {
     // remove child from subtree if present there
-    if (children->removeElement(childPtr)) {
+    if (children && children->removeElement(childPtr)) {
         // set parent of child if child was removed
         childPtr->parent = nullptr;
     }
@@ -68,12 +253,69 @@ void UIElement::setPos(int x, int y) {
     yPos = y;
 }
 
+bool UIElement::getBounds(int* x, int* y, int* w, int* h) {
+    // generic element doesn't cover any area
+    return false;
+}
+void UIElement::getClickTargets(std::vector<ClickTarget>& targets) {
+    // record element itself if it's clickable and has an area to tap on
+    int x, y, w, h;
+    if (listenForClick && getBounds(&x, &y, &w, &h)) {
+        ClickTarget target;
+        target.element = this;
+        target.x = x + w / 2;
+        target.y = y + h / 2;
+        target.label = getLabel();
+        if (!target.label && children) target.label = children->findLabel();
+        targets.push_back(target);
+    }
+    // followed by clickable elements in child subtrees
+    if (children) children->getClickTargets(targets);
+}
+
 void UIElement::freeMemory() {
     // free element's child subtree, followed by element itself
-    children->freeElements();
+    if (children) children->freeElements();
     delete this;
 }
 
+void UIElement::discard() {
+    // off the screen now, freed later
+    if (parent) removeSelf();
+    discardQueue.push_back(this);
+    discardedCount += subtreeSize();
+}
+void UIElement::discardChildren() {
+    if (!children) return;
+    size_t first = discardQueue.size();
+    children->releaseElements(discardQueue);
+    for (size_t i = first; i < discardQueue.size(); ++i) {
+        discardQueue[i]->parent = nullptr;
+        discardedCount += discardQueue[i]->subtreeSize();
+    }
+}
+int UIElement::subtreeSize() {
+    return 1 + (children ? children->subtreeSize() : 0);
+}
+
+bool UIElement::reclaim(int budget) {
+    // one element at a time, its children going back in the queue, so a
+    // slice costs the same however the discarded trees are shaped
+    while (budget-- > 0 && !discardQueue.empty()) {
+        UIElement* element = discardQueue.back();
+        discardQueue.pop_back();
+        if (element->children) element->children->releaseElements(discardQueue);
+        delete element;
+        --discardedCount;
+    }
+    return !discardQueue.empty();
+}
+void UIElement::flushDiscarded() {
+    while (reclaim(discardedCount)) { }
+}
+int UIElement::discardedElements() { return discardedCount; }
+long UIElement::liveElements() { return liveElementCount; }
+
 void UIElement::renderSelf() {
     // do nothing for generic element
 }
@@ -83,52 +325,45 @@ bool UIElement::isClicked(int x, int y) {
     return false;
 }
 
+stringT UIElement::getLabel() {
+    // generic element has no text
+    return nullptr;
+}
+
+bool UIElement::isOpaque() {
+    // generic element doesn't draw anything
+    return false;
+}
+
 /* 
 Member functions for UIElement::ElementList 
 Written by Thomas Li 
 11/27/2020 
 */
+UIElement::ElementList::~ElementList() { delete[] elements; }
+
 void UIElement::ElementList::addElement(UIElement* element) {
-    // set element as both head and tail if list is empty
-    if (!head) {
-        head = new ElementListNode;
-        head->elementPtr = element;
-        tail = head;
-    }
-    // append element to tail of list otherwise
-    else {
-        tail->next = new ElementListNode;
-        tail->next->elementPtr = element;
-        tail->next->prev = tail;
-        tail = tail->next;
+    // grow the array if it's full, most elements only have a few children
+    if (count == capacity) {
+        capacity = capacity ? capacity * 2 : 2;
+        UIElement** grown = new UIElement*[capacity];
+        for (int i = 0; i < count; ++i) grown[i] = elements[i];
+        delete[] elements;
+        elements = grown;
     }
+    // append element to end of list
+    elements[count++] = element;
 }
 bool UIElement::ElementList::removeElement(UIElement* element) {
-    // do nothing if list is empty
-    if (!head) return false;
-    // if head points to element, replace head with next element
-    if (head->elementPtr == element) {
-        ElementListNode* newHead = head->next;
-        if (newHead) newHead->prev = nullptr;
-        delete head;
-        head = newHead;
-        // return true to indicate element deletion
-        return true; 
-    }
-    // otherwise, search through list for node that points to element
-    ElementListNode* iter = head;
-    while (iter->next) {
-        if (iter->next->elementPtr == element) {
-            // remove node from list if element found
-            ElementListNode* newNext = iter->next->next;
-            if (newNext) newNext->prev = iter;
-            //delete iter->next;
-            iter->next = newNext;
+    // search through list for the first entry that points to element
+    for (int i = 0; i < count; ++i) {
+        if (elements[i] == element) {
+            // close the gap, keeping the rest in order
+            for (int j = i + 1; j < count; ++j) elements[j - 1] = elements[j];
+            --count;
             // return true to indicate element deletion
             return true;
         }
-        // move on to next element otherwise
-        iter = iter->next;
     }
     // return false if no deletion was made
     return false;
@@ -136,36 +371,49 @@ bool UIElement::ElementList::removeElement(UIElement* element) {
 void UIElement::ElementList::renderElements() {
     // iterate through list, call render function for each element
     // if list is empty, nothing happens
-    ElementListNode* iter = head;
-    while (iter) {
-        iter->elementPtr->render();
-        iter = iter->next;
-    }
+    for (int i = 0; i < count; ++i) elements[i]->render();
 }
 bool UIElement::ElementList::handleClick(int x, int y) {
     // iterate through list backwards, call handleClick function 
     // on each element
-    // return true if any calls return true
-    // if list is empty, nothing happens
-    ElementListNode* iter = tail;
-    while (iter) {
-        if (iter->elementPtr->handleClick(x, y)) {
-            return true;
-        }
-        else {
-            iter = iter->prev;
-        }
+    // return true if any calls return true - the handler may have changed
+    // this list, so stop right there
+    for (int i = count - 1; i >= 0; --i) {
+        if (elements[i]->handleClick(x, y)) return true;
     }
     return false;
 }
+void UIElement::ElementList::getClickTargets(std::vector<ClickTarget>& targets) {
+    // iterate through list in render order, collect targets from each subtree
+    for (int i = 0; i < count; ++i) elements[i]->getClickTargets(targets);
+}
+stringT UIElement::ElementList::findLabel() {
+    // depth-first search for the first element with text
+    for (int i = 0; i < count; ++i) {
+        stringT label = elements[i]->getLabel();
+        if (!label && elements[i]->children) label = elements[i]->children->findLabel();
+        if (label) return label;
+    }
+    return nullptr;
+}
+void UIElement::ElementList::collectDrawList(std::vector<DrawNode>& list) {
+    // iterate through list in render order, flatten each subtree
+    for (int i = 0; i < count; ++i) elements[i]->collectDrawList(list);
+}
 void UIElement::ElementList::freeElements() {
     // iterate through list, call freeMemory function on each element
     // if list is empty, nothing happens
-    ElementListNode* iter = head;
-    while (iter) {
-        iter->elementPtr->freeMemory();
-        iter = iter->next;
-    }
+    for (int i = 0; i < count; ++i) elements[i]->freeMemory();
+    count = 0;
+}
+int UIElement::ElementList::subtreeSize() {
+    int size = 0;
+    for (int i = 0; i < count; ++i) size += elements[i]->subtreeSize();
+    return size;
+}
+void UIElement::ElementList::releaseElements(std::vector<UIElement*>& out) {
+    out.insert(out.end(), elements, elements + count);
+    count = 0;
 }
 
 /*
@@ -193,6 +441,7 @@ Written by Thomas Li
 */
 // constructors
 RectangleElement::RectangleElement(int x, int y, int w, int h) {
+    elementType = ELEMENT_RECTANGLE;
     // assign members
     xPos = x;
     yPos = y;
@@ -203,6 +452,7 @@ RectangleElement::RectangleElement(int x, int y, int w, int h) {
     lineColor = defaultLine;
 }
 RectangleElement::RectangleElement(int x, int y, int w, int h, colorT c) {
+    elementType = ELEMENT_RECTANGLE;
     // assign members
     xPos = x;
     yPos = y;
@@ -213,6 +463,7 @@ RectangleElement::RectangleElement(int x, int y, int w, int h, colorT c) {
     lineColor = c;
 }
 RectangleElement::RectangleElement(int x, int y, int w, int h, colorT fill, colorT line) {
+    elementType = ELEMENT_RECTANGLE;
     // assign members
     xPos = x;
     yPos = y;
@@ -249,6 +500,18 @@ void RectangleElement::setDimensions(int w, int h) {
 int RectangleElement::getWidth() { return width; }
 int RectangleElement::getHeight() { return height; }
 
+bool RectangleElement::getBounds(int* x, int* y, int* w, int* h) {
+    *x = xPos;
+    *y = yPos;
+    *w = width;
+    *h = height;
+    return true;
+}
+bool RectangleElement::isOpaque() {
+    // fill covers the whole rectangle, the border is drawn on top of it
+    return true;
+}
+
 /* 
 Member functions for CircleElement
 Written by Thomas Li
@@ -256,6 +519,7 @@ Written by Thomas Li
 */
 // constructors
 CircleElement::CircleElement(int x, int y, int r) {
+    elementType = ELEMENT_CIRCLE;
     xPos = x;
     yPos = y;
     radius = r;
@@ -263,6 +527,7 @@ CircleElement::CircleElement(int x, int y, int r) {
     lineColor = defaultLine;
 }
 CircleElement::CircleElement(int x, int y, int r, colorT c) {
+    elementType = ELEMENT_CIRCLE;
     xPos = x;
     yPos = y;
     radius = r;
@@ -270,6 +535,7 @@ CircleElement::CircleElement(int x, int y, int r, colorT c) {
     lineColor = c;
 }
 CircleElement::CircleElement(int x, int y, int r, colorT fill, colorT line) {
+    elementType = ELEMENT_CIRCLE;
     xPos = x;
     yPos = y;
     radius = r;
@@ -293,6 +559,15 @@ void CircleElement::renderSelf() {
 void CircleElement::setRadius(int r) { radius = r; }
 int CircleElement::getRadius() { return radius; }
 
+bool CircleElement::getBounds(int* x, int* y, int* w, int* h) {
+    // position refers to the center, so the box extends radius in each direction
+    *x = xPos - radius;
+    *y = yPos - radius;
+    *w = 2 * radius + 1;
+    *h = 2 * radius + 1;
+    return true;
+}
+
 /*
 Member functions for TextElement
 Written by Thomas Li
@@ -311,21 +586,43 @@ Written by Thomas Li
 */
 // constructors
 StringElement::StringElement(int x, int y, stringT s) {
+    elementType = ELEMENT_STRING;
     xPos = x;
     yPos = y;
     textString = s;
     fontColor = defaultLine;
 }
 StringElement::StringElement(int x, int y, stringT s, colorT c) {
+    elementType = ELEMENT_STRING;
     xPos = x;
     yPos = y;
     textString = s;
     fontColor = c;
 }
 
+// destructor, frees the string if the element was given it
+StringElement::~StringElement() {
+    if (ownsString) free((void*) textString);
+}
+
 // member access/assignment
-void StringElement::setString(stringT s) { textString = s; }
+void StringElement::setString(stringT s) {
+    if (ownsString) free((void*) textString);
+    ownsString = false;
+    textString = s;
+}
+void StringElement::ownString() { ownsString = true; }
 stringT StringElement::getString() { return textString; }
+stringT StringElement::getLabel() { return textString; }
+
+bool StringElement::getBounds(int* x, int* y, int* w, int* h) {
+    // one character cell per character
+    *x = xPos;
+    *y = yPos;
+    *w = (int) strlen(textString) * CHAR_WIDTH;
+    *h = CHAR_HEIGHT;
+    return true;
+}
 
 // render procedure override
 void StringElement::renderSelf() {
@@ -340,19 +637,31 @@ Written by Thomas Li
 11/27/2020
 */
 // constructors
-ValueElement::ValueElement(int x, int y, std::function<int()> func) {
+ValueElement::ValueElement(int x, int y, ValueFunction func) {
+    elementType = ELEMENT_VALUE;
     xPos = x;
     yPos = y;
     valueFunction = func;
     fontColor = defaultLine;
 }
-ValueElement::ValueElement(int x, int y, std::function<int()> func, colorT c) {
+ValueElement::ValueElement(int x, int y, ValueFunction func, colorT c) {
+    elementType = ELEMENT_VALUE;
     xPos = x;
     yPos = y;
     valueFunction = func;
     fontColor = c;
 }
 
+bool ValueElement::getBounds(int* x, int* y, int* w, int* h) {
+    // width depends on how many digits the current value has
+    char buffer[16];
+    *x = xPos;
+    *y = yPos;
+    *w = snprintf(buffer, sizeof(buffer), "%d", valueFunction()) * CHAR_WIDTH;
+    *h = CHAR_HEIGHT;
+    return true;
+}
+
 // render procedure override
 void ValueElement::renderSelf() {
     // write function return value to screen at stored coordinates
@@ -367,12 +676,14 @@ Written by Thomas Li
 */
 // constructors
 SpriteElement::SpriteElement(int x, int y, int w, int h) {
+    elementType = ELEMENT_SPRITE;
     xPos = x;
     yPos = y;
     width = w;
     height = h;
 }
 SpriteElement::SpriteElement(int x, int y, int w, int h, colorT** p) {
+    elementType = ELEMENT_SPRITE;
     xPos = x;
     yPos = y;
     width = w;
@@ -401,5 +712,215 @@ void SpriteElement::renderSelf() {
 bool SpriteElement::isClicked(int x, int y) {
     return x >= xPos && x < xPos + width && y >= yPos && y < yPos + height;
 }
+bool SpriteElement::getBounds(int* x, int* y, int* w, int* h) {
+    *x = xPos;
+    *y = yPos;
+    *w = width;
+    *h = height;
+    return true;
+}
+
+/*
+Member functions for StaticPage
+Created 10/19/2026
+*/
+typedef void (*staticHandlerT)();
+
+// helpers that walk an item table, descending into included groups
+// box holds the left, top, right and bottom edges, right and bottom exclusive
+static void addItemBounds(const StaticItem* items, int count, int* box) {
+    for (int i = 0; i < count; ++i) {
+        const StaticItem& item = items[i];
+        int x = item.x, y = item.y, w = item.w, h = item.h;
+        if (item.kind == STATIC_GROUP) {
+            addItemBounds(item.group, item.groupCount, box);
+            continue;
+        }
+        if (item.kind == STATIC_CIRCLE) {
+            x -= item.w;
+            y -= item.w;
+            w = h = 2 * item.w + 1;
+        }
+        else if (item.kind == STATIC_TEXT) {
+            w = (int) strlen(item.text) * CHAR_WIDTH;
+            h = CHAR_HEIGHT;
+        }
+        if (x < box[0]) box[0] = x;
+        if (y < box[1]) box[1] = y;
+        if (x + w > box[2]) box[2] = x + w;
+        if (y + h > box[3]) box[3] = y + h;
+    }
+}
+// one node for each shape, and one more for each rectangle's label
+static void collectItems(UIElement* page, const StaticItem* items, int count, std::vector<DrawNode>& list) {
+    for (int i = 0; i < count; ++i) {
+        const StaticItem& item = items[i];
+        if (item.kind == STATIC_GROUP) {
+            collectItems(page, item.group, item.groupCount, list);
+            continue;
+        }
+        DrawNode node;
+        node.element = page;
+        node.item = &item;
+        node.label = false;
+        node.end = (int) list.size() + 1;
+        node.visible = false;
+        node.visibleFrom = 0;
+        list.push_back(node);
+        if (item.kind == STATIC_RECT && item.text) {
+            node.label = true;
+            node.end = (int) list.size() + 1;
+            list.push_back(node);
+        }
+    }
+}
+
+// single items, never groups - label picks a rectangle's label instead of
+// the rectangle itself
+static void getItemBounds(const StaticItem& item, bool label, int* x, int* y, int* w, int* h) {
+    *x = item.x;
+    *y = item.y;
+    *w = item.w;
+    *h = item.h;
+    if (label) {
+        *x += item.padding;
+        *y += item.padding;
+    }
+    if (label || item.kind == STATIC_TEXT) {
+        *w = (int) strlen(item.text) * CHAR_WIDTH;
+        *h = CHAR_HEIGHT;
+    }
+    else if (item.kind == STATIC_CIRCLE) {
+        *x -= item.w;
+        *y -= item.w;
+        *w = *h = 2 * item.w + 1;
+    }
+}
+static void renderItem(const StaticItem& item, bool label) {
+    if (label) {
+        LCD.SetFontColor(item.textColor);
+        LCD.WriteAt(item.text, item.x + item.padding, item.y + item.padding);
+        return;
+    }
+    switch (item.kind) {
+    case STATIC_RECT:
+        // same drawing as RectangleElement
+        LCD.SetDrawColor(item.fill);
+        LCD.FillRectangle(item.x, item.y, item.w, item.h);
+        if (item.fill != item.line) {
+            LCD.SetDrawColor(item.line);
+            LCD.DrawRectangle(item.x, item.y, item.w, item.h);
+        }
+        break;
+    case STATIC_CIRCLE:
+        LCD.SetDrawColor(item.fill);
+        LCD.FillCircle(item.x, item.y, item.w);
+        if (item.fill != item.line) {
+            LCD.SetDrawColor(item.line);
+            LCD.DrawCircle(item.x, item.y, item.w);
+        }
+        break;
+    case STATIC_TEXT:
+        LCD.SetFontColor(item.textColor);
+        LCD.WriteAt(item.text, item.x, item.y);
+        break;
+    }
+}
+static void renderItems(const StaticItem* items, int count) {
+    for (int i = 0; i < count; ++i) {
+        const StaticItem& item = items[i];
+        if (item.kind == STATIC_GROUP) {
+            renderItems(item.group, item.groupCount);
+            continue;
+        }
+        // rectangles get their label drawn on top
+        renderItem(item, false);
+        if (item.kind == STATIC_RECT && item.text) renderItem(item, true);
+    }
+}
+static staticHandlerT findHandler(const StaticItem* items, int count, int x, int y) {
+    // last item drawn is on top, so search backwards
+    for (int i = count - 1; i >= 0; --i) {
+        const StaticItem& item = items[i];
+        if (item.kind == STATIC_GROUP) {
+            staticHandlerT handler = findHandler(item.group, item.groupCount, x, y);
+            if (handler) return handler;
+        }
+        else if (item.handler && x >= item.x && x < item.x + item.w && y >= item.y && y < item.y + item.h) {
+            return item.handler;
+        }
+    }
+    return nullptr;
+}
+static void addItemTargets(const StaticItem* items, int count, UIElement* page, std::vector<ClickTarget>& targets) {
+    for (int i = 0; i < count; ++i) {
+        const StaticItem& item = items[i];
+        if (item.kind == STATIC_GROUP) {
+            addItemTargets(item.group, item.groupCount, page, targets);
+        }
+        else if (item.handler) {
+            ClickTarget target;
+            target.element = page;
+            target.x = item.x + item.w / 2;
+            target.y = item.y + item.h / 2;
+            target.label = item.text;
+            targets.push_back(target);
+        }
+    }
+}
+
+// constructor
+StaticPage::StaticPage(const StaticItem* items, int count) {
+    elementType = ELEMENT_STATIC_PAGE;
+    this->items = items;
+    this->count = count;
+
+    // page covers everything its items draw
+    bounds[0] = bounds[1] = 1 << 30;
+    bounds[2] = bounds[3] = -(1 << 30);
+    addItemBounds(items, count, bounds);
+    xPos = bounds[0];
+    yPos = bounds[1];
+
+    // taps are forwarded to whichever item handler isClicked found
+    setClickHandler([this] {
+        if (hit) hit();
+    });
+}
+
+bool StaticPage::getBounds(int* x, int* y, int* w, int* h) {
+    if (bounds[2] <= bounds[0]) return false;
+    *x = bounds[0];
+    *y = bounds[1];
+    *w = bounds[2] - bounds[0];
+    *h = bounds[3] - bounds[1];
+    return true;
+}
+void StaticPage::getClickTargets(std::vector<ClickTarget>& targets) {
+    // one target per clickable item, followed by any dynamic children
+    if (listenForClick) addItemTargets(items, count, this, targets);
+    if (children) children->getClickTargets(targets);
+}
+
+// function overrides
+void StaticPage::renderSelf() { renderItems(items, count); }
+bool StaticPage::isClicked(int x, int y) {
+    hit = findHandler(items, count, x, y);
+    return hit != nullptr;
+}
+
+void LazyPage::reset(UIElement* (*build)()) {
+    element = nullptr;
+    this->build = build;
+}
+UIElement* LazyPage::get() {
+    if (!element) element = build();
+    return element;
+}
+bool LazyPage::prewarm() {
+    if (element) return false;
+    get();
+    return true;
+}
 
 #endif //UIEngine
\ No newline at end of file
@@ -2,11 +2,21 @@
 #define UIEngine_H
 
 #include "FEHLCD.h"
-#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
 
 typedef FEHLCD::FEHLCDColor colorT;
 typedef const char* stringT;
 
+// Proteus screen size and text cell size, in pixels
+#define SCREEN_WIDTH 320
+#define SCREEN_HEIGHT 240
+#define CHAR_WIDTH 12
+#define CHAR_HEIGHT 17
+
 /*
 Proteus UI Engine 
 Created 11/25/2020
@@ -59,6 +69,9 @@ UIElement base class:
     - SpriteElement: Can be assigned a 2D array of color enums and will draw 
       pixels on the screen corresponding to those colors
 
+    - StaticPage: Draws a whole page of rectangles, circles, text and buttons 
+      from a constant table, for pages whose content never changes
+
 We'll likely be depending a lot on RectangleElement, TextElement, and 
 ValueElement to generate the UI. I decided to make the CircleElement and 
 SpriteElement classes just in case we needed them for extra decoration.
@@ -123,6 +136,9 @@ return type.
 C++ fortunately has anonymous functions (syntax: [] { function body goes here })
 so we don't have to separately define every procedure that we want to attach to 
 any button.
+The handler is kept inline in the element (see InlineFunction below), so a 
+lambda can only capture about a pointer's worth of values by copy - capturing 
+more is a compile error.
 
 Disabling click detection makes it so that the handleClick function won't check
 if that particular element has been clicked on. The original intention is putting
@@ -170,6 +186,55 @@ so the position members are included in the generic element class even though th
 don't get utilized in it
 
 
+bool getBounds(int* x, int* y, int* w, int* h)
+Writes the screen-space bounding box of the element itself (not including its
+children) into x, y, w, and h and returns true. Elements that don't occupy any
+area of their own, like the generic element, return false and leave the
+arguments untouched.
+
+void getClickTargets(std::vector<ClickTarget>& targets)
+Appends every element in the subtree that currently listens for clicks to 
+targets, in render order. Each target records the element, a point in the 
+middle of its bounds, and the first text label found in its subtree (or 
+nullptr if there isn't one), which is usually enough to tell buttons apart.
+
+
+These two are mainly for tools that drive the UI without a person tapping on
+the screen, like the headless bot harness under tools/, so that they can find
+buttons from the tree instead of hardcoding coordinates.
+
+
+int renderVisible()
+Draws the same frame as render, but skips every element that would end up 
+completely painted over. The subtree is first flattened in paint order, then
+walked backwards while keeping a one-bit-per-pixel map of the screen area that
+opaque elements drawn later will cover. An element whose bounds are already
+fully covered (or entirely off screen) isn't drawn, and if nothing in a 
+subtree is left to draw then the whole subtree is skipped in one step. 
+Returns the number of elements (and static page items) that were actually 
+drawn.
+
+void collectDrawList(std::vector<DrawNode>& list)
+Appends the element and its whole subtree to list in paint order, which is 
+the first step of renderVisible. A static page adds a node of its own and 
+then one for each shape and label in its table, so the items are culled one
+by one like separate elements would be.
+
+void cullDrawList(std::vector<DrawNode>& list)
+Replaces the contents of list with the flattened subtree and marks what's 
+visible, which is everything renderVisible does short of drawing. A node's
+subtree has nothing left to draw if its visibleFrom equals the visibleFrom
+of the node at its end index (or 0 at the end of the list). The display 
+list in DisplayList.h is built from this.
+
+Only elements that report isOpaque (filled rectangles, and the rectangles 
+in a static page's table) hide what's behind them, since text and circles 
+leave gaps. This matters on pages like the game menu, where the background 
+is drawn in full and then mostly covered up by the panels on top of it, and 
+the day transition screen, which covers everything with a single black 
+rectangle.
+
+
 void freeMemory()
 Frees the memory of all child elements in the element subtree, and then frees the 
 memory of the element itself
@@ -185,14 +250,148 @@ the parent element needs to be freed while the child elements are left as-is, th
 the built-in delete command should be used (I think that's how it works, at least. 
 Memory allocation isn't my strong suit.)
 
+void discard()
+Takes the element off the screen right away (if it has a parent) and queues it
+and its whole subtree to be deleted later, a few elements at a time. Use this
+instead of freeMemory for anything thrown away while the game is running, e.g.
+a page that gets rebuilt, so a big subtree never gets freed all in the middle 
+of handling a tap. Don't use the element afterwards or discard it twice.
+
+Moving another element into an existing one (*PlotElements[i] = ... and the 
+like) discards the children it had before in the same way.
+
+static bool reclaim(int budget)
+Deletes up to budget discarded elements and returns true if there are still 
+more waiting. main.cpp calls this between touches once there's nothing left to
+prewarm. If the queue ever grows past DiscardLimit elements, it's flushed all 
+at once after the tap that pushed it over, so memory stays bounded even when 
+there's no idle time.
+
+static void flushDiscarded()
+Deletes everything waiting in the queue right away.
+
+static int discardedElements()
+static long liveElements()
+Number of elements waiting to be deleted (on this thread) and number of 
+elements that currently exist (in the whole process), for keeping an eye on
+memory.
+
+*/
+class UIElement;
+class DisplayList;
+
+// element types, see UIElement::elementType
+#define ELEMENT_GENERIC 0
+#define ELEMENT_RECTANGLE 1
+#define ELEMENT_CIRCLE 2
+#define ELEMENT_STRING 3
+#define ELEMENT_VALUE 4
+#define ELEMENT_SPRITE 5
+#define ELEMENT_STATIC_PAGE 6
+
+// clickable element found in a subtree, see UIElement::getClickTargets
+struct ClickTarget {
+    UIElement* element;
+    int x, y;
+    stringT label;
+};
+
+struct StaticItem;
+
+// element in a flattened subtree, see UIElement::renderVisible - a static
+// page is followed by a node for each thing its table draws, with item set
+struct DrawNode {
+    UIElement* element;
+    const StaticItem* item; // item of the static page element, or nullptr
+    bool label; // the item's label rather than its shape
+    int end; // index one past the element's last descendant
+    bool visible; // element itself still shows up on screen
+    int visibleFrom; // number of visible nodes from here to the end of the list
+};
+
+/*
+InlineFunction class
+Created 10/19/2026
+
+Holds a callable that takes no arguments and returns R, the way
+std::function<R()> would, but always inside the object itself: the lambda's
+captures are copied into a fixed Capacity bytes of storage next to a pointer
+to a small function that calls it. Nothing is ever allocated, an empty one is
+just a null pointer, and calling one is a single indirect call.
+
+To keep that true, only callables that fit in Capacity bytes and are
+trivially copyable (plain function pointers, lambdas capturing ints,
+pointers and the like by value) are accepted - anything else is a compile
+error rather than a silent fallback to the heap. The default capacity is
+one pointer, which is enough for every handler the game has (capturing this,
+an index, a pointer to some crop data or a stats value) and keeps an element
+in the same size of malloc chunk it was in with no handler at all.
 */
+template <typename R, int Capacity = sizeof(void*)>
+class InlineFunction {
+    public:
+    InlineFunction() : invoke(nullptr) {}
+    InlineFunction(std::nullptr_t) : invoke(nullptr) {}
+
+    template <typename F, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<F>::type, InlineFunction>::value>::type>
+    InlineFunction(const F& func) {
+        static_assert(sizeof(F) <= Capacity,
+                      "callable captures too much to be stored inline, capture less or raise Capacity");
+        static_assert(alignof(F) <= alignof(void*), "callable needs more alignment than InlineFunction has");
+        static_assert(std::is_trivially_copyable<F>::value,
+                      "callable has to be trivially copyable to be stored inline (capture by value)");
+        new (storage) F(func);
+        invoke = &call<F>;
+    }
+
+    R operator()() const { return invoke(storage); }
+    explicit operator bool() const { return invoke != nullptr; }
+
+    private:
+    template <typename F>
+    static R call(const void* storage) { return (*static_cast<const F*>(storage))(); }
+
+    alignas(void*) unsigned char storage[Capacity];
+    R (*invoke)(const void*);
+};
+
+typedef InlineFunction<void> ClickHandler;
+typedef InlineFunction<int> ValueFunction;
+
+// one bit per screen pixel, marking what opaque elements drawn later will
+// cover - used by the occlusion passes in renderVisible and DisplayList
+#define COVER_WORDS ((SCREEN_WIDTH + 63) / 64)
+class CoverageMap {
+    public:
+    void clear();
+    // true if any on-screen pixel of the box isn't covered yet, in which
+    // case an opaque box then covers its area
+    bool reveal(int x, int y, int w, int h, bool opaque);
+
+    private:
+    uint64_t bits[SCREEN_HEIGHT][COVER_WORDS];
+};
+
 class UIElement {
     public:
+    UIElement();
+    // elements are moved around by value when rebuilt, never copied, since
+    // the copy would share the children
+    UIElement(UIElement&& other);
+    UIElement& operator=(UIElement&& other);
+    UIElement(const UIElement&) = delete;
+    UIElement& operator=(const UIElement&) = delete;
+    virtual ~UIElement();
+
     // public interface - see above for details
     void render();
+    int renderVisible();
+    void collectDrawList(std::vector<DrawNode>& list);
+    void cullDrawList(std::vector<DrawNode>& list);
     bool handleClick(int x, int y);
 
-    void setClickHandler(std::function<void()> func);
+    void setClickHandler(ClickHandler func);
     void disableClickHandler();
     void enableClickHandler();
 
@@ -206,9 +405,28 @@ class UIElement {
     int getY();
     void setPos(int x, int y);
 
+    virtual bool getBounds(int* x, int* y, int* w, int* h);
+    virtual void getClickTargets(std::vector<ClickTarget>& targets);
+
     void freeMemory();
+    void discard();
+
+    // deferred freeing of discarded elements
+    static const int ReclaimSlice = 32;
+    static const int DiscardLimit = 2048;
+    static bool reclaim(int budget);
+    static void flushDiscarded();
+    static int discardedElements();
+    static long liveElements();
 
     protected:
+    // text shown by the element, if any - used to label click targets
+    virtual stringT getLabel();
+
+    // true if renderSelf paints every pixel inside getBounds, meaning 
+    // anything drawn earlier in that area can't be seen
+    virtual bool isOpaque();
+
     // each element type has a different rendering procedure consisting
     // of one or more FEHLCD library function calls
     // this function gets called by the public render function, which
@@ -216,57 +434,73 @@ class UIElement {
     // for the generic UI element class, this function does nothing
     virtual void renderSelf();
 
-    // if the element doesn't do anything when clicked, as is default, 
-    // then this member is set to false to both save time in the click
-    // detection procedure and to make sure that the element doesn't 
-    // interfere with the click detection of any elements that it's 
-    // layered over (e.g. a text element serving as a button label)
-    // if the element is assigned a click handler, this member is 
-    // automatically set to true
-    bool listenForClick = false;
-
     // elements have a function to determine whether they've been 
     // touched given an x and y coordinate for the touch
     // this function gets called by the public handleClick function
     // which also checks if any of the element's children are clicked
     virtual bool isClicked(int x, int y);
 
-    // pointer to the function to be called when the element is clicked
-    // by default, this points to an empty function
-    std::function<void()> clickHandler = [] {};
-
-    // keep track of the element's position on the screen
-    // all derived classes will need this for rendering
-    int xPos, yPos;
+    // function to be called when the element is clicked, stored inline
+    // so that setting one never allocates - empty means do nothing
+    ClickHandler clickHandler;
 
     // keep track of parent element - this pointer gets assigned
     // in the add and remove functions
     UIElement* parent = nullptr;
+
+    // keep track of the element's position on the screen
+    // all derived classes use these for rendering
+    int xPos = 0, yPos = 0;
+
+    // which class the element is, set by the constructors so that the 
+    // display list can read an element's members without a virtual call
+    int elementType = ELEMENT_GENERIC;
+    friend class DisplayList;
+
+    // if the element doesn't do anything when clicked, as is default, 
+    // then this member is set to false to both save time in the click
+    // detection procedure and to make sure that the element doesn't 
+    // interfere with the click detection of any elements that it's 
+    // layered over (e.g. a text element serving as a button label)
+    // if the element is assigned a click handler, this member is 
+    // automatically set to true
+    bool listenForClick = false;
     
-    // singly-linked list provides internal mechanism for
-    // managing child elements
+    // list of child elements in render order, kept as one growable array
+    // of pointers rather than a node per child
     class ElementList {
         public:
+        ~ElementList();
+
         void addElement(UIElement* element);
         bool removeElement(UIElement* element);
 
         void renderElements();
         bool handleClick(int x, int y);
 
+        void getClickTargets(std::vector<ClickTarget>& targets);
+        stringT findLabel();
+        void collectDrawList(std::vector<DrawNode>& list);
+
         void freeElements();
+        int subtreeSize();
+        // appends the elements to out and empties the list
+        void releaseElements(std::vector<UIElement*>& out);
 
         private:
-        struct ElementListNode {
-            UIElement* elementPtr = nullptr;
-            ElementListNode* next = nullptr;
-            ElementListNode* prev = nullptr;
-        };
-
-        ElementListNode* head = nullptr;
-        ElementListNode* tail = nullptr;
+        UIElement** elements = nullptr;
+        int count = 0;
+        int capacity = 0;
     };
 
-    ElementList* children = new ElementList();
+    // most elements are leaves, so the list is only allocated by the
+    // first addChild - null means no children
+    ElementList* children = nullptr;
+
+    // number of elements in the subtree, including this one
+    int subtreeSize();
+    // discard every child, leaving the element with none
+    void discardChildren();
 };
 
 /*
@@ -288,13 +522,12 @@ class PolygonElement : public UIElement {
     void setColor(colorT color); // apply color to both fill and line
 
     protected:
+    friend class DisplayList;
+
     // virtual functions passed from base class to subclasses
     virtual void renderSelf();
     virtual bool isClicked(int x, int y);
 
-    // internal members passed from base class to subclasses
-    int xPos, yPos;
-
     // new internal members
     colorT fillColor, lineColor;
 };
@@ -327,10 +560,15 @@ class RectangleElement : public PolygonElement {
     int getWidth();
     int getHeight();
 
+    bool getBounds(int* x, int* y, int* w, int* h);
+
     protected:
+    friend class DisplayList;
+
     // function overrides
     void renderSelf();
     bool isClicked(int x, int y);
+    bool isOpaque();
 
     // new internal members
     int width, height;
@@ -363,7 +601,11 @@ class CircleElement : public PolygonElement {
     void setRadius(int r);
     int getRadius();
 
+    bool getBounds(int* x, int* y, int* w, int* h);
+
     protected:
+    friend class DisplayList;
+
     // function overrides
     void renderSelf();
 
@@ -387,13 +629,12 @@ class TextElement : public UIElement {
     void setFontColor(colorT c);
 
     protected:
+    friend class DisplayList;
+
     // virtual functions passed from base class to subclasses
     virtual void renderSelf();
     virtual bool isClicked(int x, int y);
 
-    // internal members passed from base class to subclasses
-    int xPos, yPos;
-
     // new internal members
     colorT fontColor;
 };
@@ -424,13 +665,23 @@ class StringElement : public TextElement {
     // member access/assignment
     void setString(stringT s);
     stringT getString();
+    // hand the current string (which has to come from malloc) over to the
+    // element, which frees it when destroyed or given another string
+    void ownString();
+    ~StringElement();
+
+    bool getBounds(int* x, int* y, int* w, int* h);
 
     protected:
+    friend class DisplayList;
+
     // function overrides
     void renderSelf();
+    stringT getLabel();
 
     // new internal members
     stringT textString;
+    bool ownsString = false;
 };
 
 /*
@@ -449,15 +700,19 @@ class ValueElement : public TextElement {
     public:
     // position and function pointer need to be specified by constructor
     // color can be specified or left at default
-    ValueElement(int x, int y, std::function<int()> func);
-    ValueElement(int x, int y, std::function<int()> func, colorT c);
+    ValueElement(int x, int y, ValueFunction func);
+    ValueElement(int x, int y, ValueFunction func, colorT c);
+
+    bool getBounds(int* x, int* y, int* w, int* h);
 
     protected:
+    friend class DisplayList;
+
     // function overrides
     void renderSelf();
 
     // new internal members
-    std::function<int()> valueFunction;
+    ValueFunction valueFunction;
 };
 
 /*
@@ -483,7 +738,11 @@ class SpriteElement : public UIElement {
     void resize(int w, int h);
     void setPattern(colorT** p);
 
+    bool getBounds(int* x, int* y, int* w, int* h);
+
     protected:
+    friend class DisplayList;
+
     // function overrides
     void renderSelf();
     bool isClicked(int x, int y);
@@ -492,4 +751,137 @@ class SpriteElement : public UIElement {
     int width, height;
     colorT** pattern;
 };
+
+/*
+StaticPage class
+Created 10/19/2026
+
+Pages like the credits or the main menu never change once they're built, but
+building them out of the classes above costs a heap allocation (plus a child
+list and a click handler) for every rectangle and every line of text. A 
+StaticPage instead draws the whole page from a table of StaticItem entries 
+declared constexpr, so the geometry, colors, strings and click handlers all 
+sit in read-only storage and nothing runs at startup to build them. Creating
+the page itself is a single element.
+
+Tables are written with the constexpr helpers below:
+
+    - staticRect: filled rectangle with a border, like RectangleElement
+    - staticLabel: rectangle with a line of text inside it, and optionally a
+      click handler (a plain function, since lambdas can't go in a constant
+      table) - this is what titles and buttons are made of
+    - staticCircle: circle around a center point, like CircleElement
+    - staticText: line of text, like StringElement
+    - staticGroup: includes another table, so shared parts like a background
+      only need to be written once
+
+Items are drawn in table order, and a tap goes to the last item drawn under
+it that has a handler, same as a tree of regular elements would do. A 
+StaticPage is still a UIElement, so it can be switched to like any other 
+page, and dynamic elements (e.g. values that change) can be added to it as 
+children; they get drawn on top of the table.
+*/
+#define STATIC_RECT 0
+#define STATIC_CIRCLE 1
+#define STATIC_TEXT 2
+#define STATIC_GROUP 3
+
+struct StaticItem {
+    int kind;
+    int x, y, w, h; // circles use x and y as the center and w as the radius
+    colorT fill, line;
+    stringT text; // label of a rectangle, or the text itself
+    colorT textColor;
+    int padding; // offset of a rectangle's label from its top left corner
+    void (*handler)(); // rectangles only, nullptr if not clickable
+    const StaticItem* group; // table included by a group
+    int groupCount;
+};
+
+constexpr StaticItem staticRect(int x, int y, int w, int h, colorT fill, colorT line) {
+    return StaticItem{STATIC_RECT, x, y, w, h, fill, line, nullptr, fill, 0, nullptr, nullptr, 0};
+}
+constexpr StaticItem staticLabel(int x, int y, int w, int h, colorT fill, stringT label, colorT textColor,
+                                 int padding, void (*handler)()) {
+    return StaticItem{STATIC_RECT, x, y, w, h, fill, fill, label, textColor, padding, handler, nullptr, 0};
+}
+constexpr StaticItem staticCircle(int x, int y, int r, colorT fill, colorT line) {
+    return StaticItem{STATIC_CIRCLE, x, y, r, r, fill, line, nullptr, fill, 0, nullptr, nullptr, 0};
+}
+constexpr StaticItem staticText(int x, int y, stringT s, colorT c) {
+    return StaticItem{STATIC_TEXT, x, y, 0, 0, c, c, s, c, 0, nullptr, nullptr, 0};
+}
+template <int N>
+constexpr StaticItem staticGroup(const StaticItem (&items)[N]) {
+    return StaticItem{STATIC_GROUP, 0, 0, 0, 0, FEHLCD::Black, FEHLCD::Black, nullptr, FEHLCD::Black, 0,
+                      nullptr, items, N};
+}
+
+class StaticPage : public UIElement {
+    public:
+    // the table has to outlive the page, which constexpr tables always do
+    template <int N>
+    StaticPage(const StaticItem (&items)[N]) : StaticPage(items, N) { }
+    StaticPage(const StaticItem* items, int count);
+
+    bool getBounds(int* x, int* y, int* w, int* h);
+    void getClickTargets(std::vector<ClickTarget>& targets);
+
+    protected:
+    friend class DisplayList;
+    // collectDrawList adds a draw node for each item
+    friend class UIElement;
+
+    // function overrides
+    void renderSelf();
+    bool isClicked(int x, int y);
+
+    // new internal members
+    const StaticItem* items;
+    int count;
+    int bounds[4]; // union of all items, computed once
+    void (*hit)() = nullptr; // handler found by the last isClicked call
+};
+
+/*
+LazyPage class
+Created 10/19/2026
+
+Handle for a page or panel that isn't built until something actually uses
+it. Give it the function that builds the page with reset(), and the first
+time the handle is used as a UIElement* (passed to switchToPage, or used
+with ->) the function gets called and its result kept. Until then the page
+costs nothing, so pages a player never opens are never built.
+
+Comparing a handle against an element pointer doesn't build the page - a
+page that hasn't been built can't be on screen anyway. prewarm() builds the
+page ahead of time, e.g. while waiting for input, and returns false if it
+was already built.
+
+Handles are plain values, so they can be saved and restored with the rest
+of a session.
+*/
+class LazyPage {
+    public:
+    void reset(UIElement* (*build)());
+
+    UIElement* get();
+    operator UIElement*() { return get(); }
+    UIElement* operator->() { return get(); }
+
+    bool built() const { return element != nullptr; }
+    bool prewarm();
+
+    // comparing never builds the page; the parameters match CurrentPage
+    // and the like exactly, so these win over comparing through the
+    // conversion above
+    friend bool operator==(UIElement* e, const LazyPage& page) { return e == page.element; }
+    friend bool operator==(const LazyPage& page, UIElement* e) { return e == page.element; }
+    friend bool operator!=(UIElement* e, const LazyPage& page) { return e != page.element; }
+    friend bool operator!=(const LazyPage& page, UIElement* e) { return e != page.element; }
+
+    private:
+    UIElement* element = nullptr;
+    UIElement* (*build)() = nullptr;
+};
 #endif //UIEngine_H
\ No newline at end of file
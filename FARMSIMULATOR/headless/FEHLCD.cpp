@@ -0,0 +1,461 @@
+#include "FEHLCD.h"
+
+#include <cstdio>
+#include <cstring>
+
+// FEHLCD_NO_SSSE3 forces the scalar expansion everywhere, so it can be
+// checked on machines that would otherwise always take the SSSE3 path
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(FEHLCD_NO_SSSE3)
+#include <tmmintrin.h>
+#define FEHLCD_SSSE3
+#endif
+
+/*
+Headless FEHLCD implementation
+Created 10/19/2026
+
+See FEHLCD.h for the conventions this follows. Text uses a classic 5-by-7
+column font scaled up 2x and placed inside the firmware's 12-by-17 cells.
+*/
+
+// 5x7 glyphs for printable ASCII (0x20 to 0x7E), one byte per column,
+// least significant bit at the top
+static const unsigned char Font5x7[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00},
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x08,0x2A,0x1C,0x2A,0x08}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31},
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03},
+    {0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00},
+    {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x41,0x22,0x14,0x08,0x00}, {0x02,0x01,0x51,0x09,0x06},
+    {0x32,0x49,0x79,0x41,0x3E}, {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x01,0x01}, {0x3E,0x41,0x41,0x51,0x32},
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x04,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31},
+    {0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x7F,0x20,0x18,0x20,0x7F},
+    {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x00,0x7F,0x41,0x41},
+    {0x02,0x04,0x08,0x10,0x20}, {0x41,0x41,0x7F,0x00,0x00}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20},
+    {0x38,0x44,0x44,0x48,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x08,0x14,0x54,0x54,0x3C},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x44,0x3D,0x00}, {0x00,0x7F,0x10,0x28,0x44},
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+    {0x7C,0x14,0x14,0x14,0x08}, {0x08,0x14,0x14,0x18,0x7C}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20},
+    {0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44}, {0x0C,0x50,0x50,0x50,0x3C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x7F,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x08,0x08,0x2A,0x1C,0x08}
+};
+
+// the font scaled up 2x, as horizontal runs per font row - each run covers
+// two pixel rows, starting dy pixels down from the top of the cell (one pixel
+// of left and top padding inside the cell), and is always an even number of
+// pixels long
+struct GlyphRun {
+    unsigned char dy, dx, length;
+};
+struct Glyph {
+    GlyphRun runs[21]; // at most three runs in each of seven rows
+    int count;
+};
+struct GlyphAtlas {
+    Glyph glyphs[95];
+
+    GlyphAtlas() {
+        for (int g = 0; g < 95; ++g) {
+            Glyph& glyph = glyphs[g];
+            glyph.count = 0;
+            for (int row = 0; row < 7; ++row) {
+                int col = 0;
+                while (col < 5) {
+                    if (!(Font5x7[g][col] & (1 << row))) {
+                        ++col;
+                        continue;
+                    }
+                    int start = col;
+                    while (col < 5 && (Font5x7[g][col] & (1 << row))) ++col;
+                    GlyphRun run = {(unsigned char) (1 + row * 2), (unsigned char) (1 + start * 2),
+                                    (unsigned char) ((col - start) * 2)};
+                    glyph.runs[glyph.count++] = run;
+                }
+            }
+        }
+    }
+};
+static const GlyphAtlas Atlas;
+
+// fill pixels [x1, x2] of a packed row with one palette index, no clipping
+static inline void fillNibbles(unsigned char* row, int x1, int x2, unsigned char index) {
+    if (x1 & 1) {
+        row[x1 >> 1] = (unsigned char) ((row[x1 >> 1] & 0x0F) | (index << 4));
+        ++x1;
+    }
+    if (x1 <= x2 && !(x2 & 1)) {
+        row[x2 >> 1] = (unsigned char) ((row[x2 >> 1] & 0xF0) | index);
+        --x2;
+    }
+    if (x1 < x2) memset(row + (x1 >> 1), index * 0x11, (x2 - x1 + 1) >> 1);
+}
+
+thread_local FEHLCD LCD;
+
+FEHLCD::FEHLCD() {
+    // the named colors always get the first slots
+    static const unsigned int named[] = {Black, White, Red, Green, Blue, Scarlet, Gray};
+    paletteCount = 0;
+    for (unsigned int color : named) palette[paletteCount++] = color;
+    for (int i = paletteCount; i < PaletteSize; ++i) palette[i] = 0;
+    pairTableValid = false;
+
+    foregroundIndex = paletteIndex(White);
+    backgroundIndex = paletteIndex(Black);
+    touchHead = 0;
+    touchCount = 0;
+    pixelsWritten = 0;
+    stateChanges = 0;
+    Clear();
+}
+
+// palette
+unsigned char FEHLCD::paletteIndex(unsigned int color) {
+    color &= 0xFFFFFF;
+    for (int i = 0; i < paletteCount; ++i) {
+        if (palette[i] == color) return (unsigned char) i;
+    }
+    if (paletteCount < PaletteSize) {
+        palette[paletteCount] = color;
+        pairTableValid = false;
+        return (unsigned char) paletteCount++;
+    }
+    // palette is full, settle for the closest color already in it
+    int best = 0;
+    long long bestDistance = -1;
+    for (int i = 0; i < PaletteSize; ++i) {
+        long long distance = 0;
+        for (int shift = 0; shift < 24; shift += 8) {
+            int d = (int) ((palette[i] >> shift) & 0xFF) - (int) ((color >> shift) & 0xFF);
+            distance += d * d;
+        }
+        if (bestDistance < 0 || distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    return (unsigned char) best;
+}
+
+// screen clearing
+void FEHLCD::Clear() { Clear(palette[backgroundIndex]); }
+void FEHLCD::Clear(unsigned int color) {
+    unsigned char index = paletteIndex(color);
+    memset(framebuffer, index * 0x11, sizeof(framebuffer));
+    memset(dirty, 1, sizeof(dirty));
+}
+
+// draw state
+void FEHLCD::SetDrawColor(unsigned int color) { foregroundIndex = paletteIndex(color); ++stateChanges; }
+void FEHLCD::SetFontColor(unsigned int color) { foregroundIndex = paletteIndex(color); ++stateChanges; }
+void FEHLCD::SetBackgroundColor(unsigned int color) { backgroundIndex = paletteIndex(color); ++stateChanges; }
+
+// clipped single-pixel write
+void FEHLCD::plot(int x, int y, unsigned char index) {
+    if (x < 0 || x >= Width || y < 0 || y >= Height) return;
+    unsigned char* byte = framebuffer + y * RowBytes + (x >> 1);
+    if (x & 1) *byte = (unsigned char) ((*byte & 0x0F) | (index << 4));
+    else *byte = (unsigned char) ((*byte & 0xF0) | index);
+    dirty[y] = true;
+    ++pixelsWritten;
+}
+
+// clipped horizontal run [x1, x2] on row y
+void FEHLCD::span(int y, int x1, int x2, unsigned char index) {
+    if (y < 0 || y >= Height) return;
+    if (x1 > x2) { int t = x1; x1 = x2; x2 = t; }
+    if (x1 < 0) x1 = 0;
+    if (x2 >= Width) x2 = Width - 1;
+    if (x1 > x2) return;
+    pixelsWritten += x2 - x1 + 1;
+    fillNibbles(framebuffer + y * RowBytes, x1, x2, index);
+    dirty[y] = true;
+}
+
+// primitives
+void FEHLCD::DrawPixel(int x, int y) { plot(x, y, foregroundIndex); }
+void FEHLCD::DrawHorizontalLine(int y, int x1, int x2) { span(y, x1, x2, foregroundIndex); }
+void FEHLCD::DrawVerticalLine(int x, int y1, int y2) {
+    if (y1 > y2) { int t = y1; y1 = y2; y2 = t; }
+    for (int y = y1; y <= y2; ++y) {
+        plot(x, y, foregroundIndex);
+    }
+}
+void FEHLCD::DrawRectangle(int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    span(y, x, x + w - 1, foregroundIndex);
+    span(y + h - 1, x, x + w - 1, foregroundIndex);
+    for (int row = y + 1; row < y + h - 1; ++row) {
+        plot(x, row, foregroundIndex);
+        plot(x + w - 1, row, foregroundIndex);
+    }
+}
+void FEHLCD::FillRectangle(int x, int y, int w, int h) {
+    if (w <= 0) return;
+    for (int row = y; row < y + h; ++row) {
+        span(row, x, x + w - 1, foregroundIndex);
+    }
+}
+void FEHLCD::DrawCircle(int x0, int y0, int r) {
+    // midpoint circle, eight octants at a time
+    int x = r, y = 0, err = 1 - r;
+    while (x >= y) {
+        plot(x0 + x, y0 + y, foregroundIndex); plot(x0 - x, y0 + y, foregroundIndex);
+        plot(x0 + x, y0 - y, foregroundIndex); plot(x0 - x, y0 - y, foregroundIndex);
+        plot(x0 + y, y0 + x, foregroundIndex); plot(x0 - y, y0 + x, foregroundIndex);
+        plot(x0 + y, y0 - x, foregroundIndex); plot(x0 - y, y0 - x, foregroundIndex);
+        ++y;
+        if (err < 0) {
+            err += 2 * y + 1;
+        }
+        else {
+            --x;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+void FEHLCD::FillCircle(int x0, int y0, int r) {
+    // one span per row, widest x with dx^2 + dy^2 <= r^2 + r
+    int limit = r * r + r;
+    int dx = r;
+    for (int dy = 0; dy <= r; ++dy) {
+        while (dx > 0 && dx * dx + dy * dy > limit) --dx;
+        span(y0 + dy, x0 - dx, x0 + dx, foregroundIndex);
+        if (dy) span(y0 - dy, x0 - dx, x0 + dx, foregroundIndex);
+    }
+}
+
+// text
+// runs for a whole string, from the cache if it has been drawn before -
+// runs don't depend on the color, so the string alone is the key
+const FEHLCD::CachedText& FEHLCD::cachedText(const char* s) {
+    // FNV-1a over the string, which also measures it
+    unsigned long long hash = 14695981039346656037ull;
+    int n = 0;
+    for (; s[n]; ++n) hash = (hash ^ (unsigned char) s[n]) * 1099511628211ull;
+
+    CachedText& entry = textCache[hash % TextCacheSize];
+    if (entry.hash == hash && entry.text.size() == (size_t) n && !memcmp(entry.text.data(), s, n)) {
+        return entry;
+    }
+
+    // not cached (or evicted by another string), build from the atlas
+    entry.hash = hash;
+    entry.text.assign(s, n);
+    entry.width = n * CharWidth;
+    entry.pixels = 0;
+    entry.runs.clear();
+    for (int i = 0; i < n; ++i) {
+        if (s[i] < 0x20 || s[i] > 0x7E) continue;
+        const Glyph& glyph = Atlas.glyphs[s[i] - 0x20];
+        for (int r = 0; r < glyph.count; ++r) {
+            const GlyphRun& run = glyph.runs[r];
+            TextRun textRun = {(short) (i * CharWidth + run.dx), run.dy, run.length};
+            entry.runs.push_back(textRun);
+            entry.pixels += 2 * run.length;
+        }
+    }
+    return entry;
+}
+void FEHLCD::blitText(const CachedText& text, int x, int y) {
+    // everything in locals, pixel stores could otherwise alias them
+    unsigned char index = foregroundIndex;
+    const TextRun* runs = text.runs.data();
+    int count = (int) text.runs.size();
+
+    if (x < 0 || y < 0 || x + text.width > Width || y + CharHeight > Height) {
+        // partly off screen, clip run by run
+        for (int i = 0; i < count; ++i) {
+            int x1 = x + runs[i].dx, x2 = x1 + runs[i].length - 1;
+            span(y + runs[i].dy, x1, x2, index);
+            span(y + runs[i].dy + 1, x1, x2, index);
+        }
+        return;
+    }
+
+    unsigned char* origin = framebuffer + y * RowBytes;
+    for (int i = 0; i < count; ++i) {
+        unsigned char* row = origin + runs[i].dy * RowBytes;
+        int x1 = x + runs[i].dx, x2 = x1 + runs[i].length - 1;
+        fillNibbles(row, x1, x2, index);
+        fillNibbles(row + RowBytes, x1, x2, index);
+    }
+    memset(dirty + y, 1, CharHeight);
+    pixelsWritten += text.pixels;
+}
+void FEHLCD::writeChar(char c, int x, int y) {
+    if (c < 0x20 || c > 0x7E) return;
+    const Glyph& glyph = Atlas.glyphs[c - 0x20];
+    unsigned char index = foregroundIndex;
+    if (x >= 0 && y >= 0 && x + CharWidth <= Width && y + CharHeight <= Height) {
+        unsigned char* origin = framebuffer + y * RowBytes;
+        unsigned long long written = 0;
+        for (int r = 0; r < glyph.count; ++r) {
+            const GlyphRun& run = glyph.runs[r];
+            unsigned char* row = origin + run.dy * RowBytes;
+            int x1 = x + run.dx, x2 = x1 + run.length - 1;
+            fillNibbles(row, x1, x2, index);
+            fillNibbles(row + RowBytes, x1, x2, index);
+            written += 2 * run.length;
+        }
+        memset(dirty + y, 1, CharHeight);
+        pixelsWritten += written;
+        return;
+    }
+    for (int r = 0; r < glyph.count; ++r) {
+        const GlyphRun& run = glyph.runs[r];
+        span(y + run.dy, x + run.dx, x + run.dx + run.length - 1, index);
+        span(y + run.dy + 1, x + run.dx, x + run.dx + run.length - 1, index);
+    }
+}
+void FEHLCD::WriteAt(const char* s, int x, int y) {
+    blitText(cachedText(s), x, y);
+}
+void FEHLCD::WriteAt(int i, int x, int y) {
+    // peel off digits from the right, then draw them straight from the atlas
+    char digits[11];
+    int count = 0;
+    unsigned int v = i < 0 ? 0u - (unsigned int) i : (unsigned int) i;
+    do {
+        digits[count++] = (char) ('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (i < 0) {
+        writeChar('-', x, y);
+        x += CharWidth;
+    }
+    while (count) {
+        writeChar(digits[--count], x, y);
+        x += CharWidth;
+    }
+}
+void FEHLCD::WriteAt(float f, int x, int y) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.3f", f);
+    WriteAt(buffer, x, y);
+}
+void FEHLCD::WriteAt(bool b, int x, int y) { WriteAt(b ? "true" : "false", x, y); }
+void FEHLCD::WriteAt(char c, int x, int y) { writeChar(c, x, y); }
+
+// input
+bool FEHLCD::Touch(int* x, int* y) {
+    if (!touchCount) return false;
+    *x = touchX[touchHead];
+    *y = touchY[touchHead];
+    touchHead = (touchHead + 1) % TouchQueueSize;
+    --touchCount;
+    return true;
+}
+bool FEHLCD::Touch(float* x, float* y) {
+    int ix, iy;
+    if (!Touch(&ix, &iy)) return false;
+    *x = (float) ix;
+    *y = (float) iy;
+    return true;
+}
+void FEHLCD::QueueTouch(int x, int y) {
+    // drop the touch if the queue is full
+    if (touchCount == TouchQueueSize) return;
+    int slot = (touchHead + touchCount) % TouchQueueSize;
+    touchX[slot] = x;
+    touchY[slot] = y;
+    ++touchCount;
+}
+
+// present
+#ifdef FEHLCD_SSSE3
+// expand one packed row, 32 pixels at a time: split each byte into its two
+// indices, look each color byte up with pshufb against a 16-entry table per
+// channel, then interleave the channels back into 0x00RRGGBB pixels
+__attribute__((target("ssse3")))
+static void expandRowSSSE3(const unsigned char* packed, unsigned int* out, const unsigned int* palette) {
+    unsigned char planes[3][16];
+    for (int i = 0; i < 16; ++i) {
+        planes[0][i] = (unsigned char) palette[i];
+        planes[1][i] = (unsigned char) (palette[i] >> 8);
+        planes[2][i] = (unsigned char) (palette[i] >> 16);
+    }
+    __m128i blue = _mm_loadu_si128((const __m128i*) planes[0]);
+    __m128i green = _mm_loadu_si128((const __m128i*) planes[1]);
+    __m128i red = _mm_loadu_si128((const __m128i*) planes[2]);
+    __m128i low = _mm_set1_epi8(0x0F);
+    __m128i zero = _mm_setzero_si128();
+
+    for (int i = 0; i < FEHLCD::Width / 2; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (packed + i));
+        __m128i left = _mm_and_si128(bytes, low);
+        __m128i right = _mm_and_si128(_mm_srli_epi16(bytes, 4), low);
+        __m128i indices[2] = {_mm_unpacklo_epi8(left, right), _mm_unpackhi_epi8(left, right)};
+        for (int half = 0; half < 2; ++half) {
+            __m128i b = _mm_shuffle_epi8(blue, indices[half]);
+            __m128i g = _mm_shuffle_epi8(green, indices[half]);
+            __m128i r = _mm_shuffle_epi8(red, indices[half]);
+            __m128i bgLow = _mm_unpacklo_epi8(b, g), bgHigh = _mm_unpackhi_epi8(b, g);
+            __m128i rLow = _mm_unpacklo_epi8(r, zero), rHigh = _mm_unpackhi_epi8(r, zero);
+            __m128i* q = (__m128i*) (out + 2 * i + 16 * half);
+            _mm_storeu_si128(q, _mm_unpacklo_epi16(bgLow, rLow));
+            _mm_storeu_si128(q + 1, _mm_unpackhi_epi16(bgLow, rLow));
+            _mm_storeu_si128(q + 2, _mm_unpacklo_epi16(bgHigh, rHigh));
+            _mm_storeu_si128(q + 3, _mm_unpackhi_epi16(bgHigh, rHigh));
+        }
+    }
+}
+#endif
+
+void FEHLCD::present() {
+    if (presented.empty()) {
+        presented.resize(Width * Height);
+        memset(dirty, 1, sizeof(dirty));
+    }
+#ifdef FEHLCD_SSSE3
+    static const bool ssse3 = __builtin_cpu_supports("ssse3");
+#else
+    static const bool ssse3 = false;
+#endif
+    if (!ssse3 && !pairTableValid) {
+        for (int byte = 0; byte < 256; ++byte) {
+            pairTable[byte] = ((unsigned long long) palette[byte >> 4] << 32) | palette[byte & 0x0F];
+        }
+        pairTableValid = true;
+    }
+
+    for (int y = 0; y < Height; ++y) {
+        if (!dirty[y]) continue;
+        dirty[y] = false;
+        const unsigned char* packed = framebuffer + y * RowBytes;
+        unsigned int* out = presented.data() + y * Width;
+#ifdef FEHLCD_SSSE3
+        if (ssse3) {
+            expandRowSSSE3(packed, out, palette);
+            continue;
+        }
+#endif
+        for (int i = 0; i < RowBytes; ++i) memcpy(out + 2 * i, &pairTable[packed[i]], sizeof(unsigned long long));
+    }
+}
+
+void FEHLCD::Update() { present(); }
+
+const unsigned int* FEHLCD::Pixels() {
+    present();
+    return presented.data();
+}
+unsigned int FEHLCD::GetPixel(int x, int y) {
+    if (x < 0 || x >= Width || y < 0 || y >= Height) return 0;
+    unsigned char byte = framebuffer[y * RowBytes + (x >> 1)];
+    return palette[x & 1 ? byte >> 4 : byte & 0x0F];
+}
+
+unsigned long long FEHLCD::PixelsWritten() { return pixelsWritten; }
+unsigned long long FEHLCD::StateChanges() { return stateChanges; }
+void FEHLCD::ResetCounters() {
+    pixelsWritten = 0;
+    stateChanges = 0;
+}
@@ -0,0 +1,170 @@
+#ifndef FEHLCD_H
+#define FEHLCD_H
+
+#include <string>
+#include <vector>
+
+/*
+Headless FEHLCD
+Created 10/19/2026
+
+Drop-in replacement for the FEHLCD class from the simulator firmware that
+draws into an in-memory framebuffer instead of a window. Tools under tools/
+are compiled with -Iheadless so that UIEngine.cpp, GameState.cpp and
+UIElements.h pick this header up in place of the firmware one, which lets
+the real UI tree run without a display (or an internet connection to fetch
+the firmware).
+
+Only the parts of the firmware interface that the game actually uses are
+implemented. Colors are passed in as 0xRRGGBB values, same as the firmware.
+
+The framebuffer itself is 4-bit palette indexed, two pixels per byte, since
+the game only ever draws in a handful of colors: the palette starts out as
+the FEHLCDColor values and any other color gets the next free slot (once all
+16 are taken, the closest existing entry is used instead). Pixels are only
+expanded to 0xRRGGBB when they are presented - Update or Pixels - and only
+for rows drawn to since the last present, with an SSSE3 shuffle kernel when
+the CPU has it (building with FEHLCD_NO_SSSE3 always uses the scalar path,
+see make golden-scalar).
+
+Coordinates follow the conventions the UI engine already assumes:
+    - FillRectangle/DrawRectangle cover [x, x+w) by [y, y+h)
+    - text is drawn in 12-by-17 pixel character cells, foreground only
+    - SetDrawColor and SetFontColor set the one foreground color used by
+      both shapes and text, as they do on the firmware
+    - anything outside the 320-by-240 screen is clipped
+
+Text is drawn from a glyph atlas, the font already scaled up and broken into
+horizontal runs. The runs for a whole string are worked out the first time it
+is drawn and kept in a small per-LCD cache keyed by the string's contents,
+so labels drawn every frame only cost one short fill per run. Integers are
+drawn digit by digit straight from the atlas without formatting them into a
+string first.
+
+Touches can be queued with QueueTouch so that main-loop style code can be
+driven by a script; Touch returns false once the queue is empty.
+
+LCD is thread_local here, like the UI globals in UIElements.h, so that a
+multi-session host can render a different session on each worker thread.
+*/
+class FEHLCD {
+    public:
+    typedef enum {
+        Black = 0x000000u,
+        White = 0xFFFFFFu,
+        Red = 0xFF0000u,
+        Green = 0x00FF00u,
+        Blue = 0x0000FFu,
+        Scarlet = 0x990000u,
+        Gray = 0x999999u
+    } FEHLCDColor;
+
+    // screen and character cell dimensions
+    static const int Width = 320;
+    static const int Height = 240;
+    static const int CharWidth = 12;
+    static const int CharHeight = 17;
+
+    FEHLCD();
+
+    // screen clearing
+    void Clear();
+    void Clear(unsigned int color);
+
+    // draw state
+    void SetDrawColor(unsigned int color);
+    void SetFontColor(unsigned int color);
+    void SetBackgroundColor(unsigned int color);
+
+    // primitives
+    void DrawPixel(int x, int y);
+    void DrawHorizontalLine(int y, int x1, int x2);
+    void DrawVerticalLine(int x, int y1, int y2);
+    void DrawRectangle(int x, int y, int w, int h);
+    void FillRectangle(int x, int y, int w, int h);
+    void DrawCircle(int x0, int y0, int r);
+    void FillCircle(int x0, int y0, int r);
+
+    // text
+    void WriteAt(const char* s, int x, int y);
+    void WriteAt(int i, int x, int y);
+    void WriteAt(float f, int x, int y);
+    void WriteAt(bool b, int x, int y);
+    void WriteAt(char c, int x, int y);
+
+    // input
+    bool Touch(int* x, int* y);
+    bool Touch(float* x, float* y);
+    void QueueTouch(int x, int y);
+
+    // expands rows drawn to since the last present into the 0xRRGGBB
+    // buffer returned by Pixels
+    void Update();
+
+    // read-only access to the presented frame, one 0xRRGGBB value per pixel,
+    // row-major (presents first, so it's always current)
+    const unsigned int* Pixels();
+    unsigned int GetPixel(int x, int y);
+
+    // counters since the last reset: pixels drawn (after clipping, and not
+    // counting Clear - divided by Width * Height this is the overdraw of a
+    // frame) and calls to the Set*Color functions
+    unsigned long long PixelsWritten();
+    unsigned long long StateChanges();
+    void ResetCounters();
+
+    private:
+    // one run of text pixels two rows tall, relative to the text's top left
+    struct TextRun {
+        short dx;
+        unsigned char dy, length;
+    };
+    // a string broken into runs once, see cachedText
+    struct CachedText {
+        unsigned long long hash;
+        std::string text;
+        int width; // in pixels, always a multiple of CharWidth
+        unsigned long long pixels;
+        std::vector<TextRun> runs;
+    };
+    static const int TextCacheSize = 128;
+
+    const CachedText& cachedText(const char* s);
+    void blitText(const CachedText& text, int x, int y);
+    void writeChar(char c, int x, int y);
+    void plot(int x, int y, unsigned char index);
+    void span(int y, int x1, int x2, unsigned char index);
+
+    // palette slot for a color, adding it if there's room
+    unsigned char paletteIndex(unsigned int color);
+    void present();
+
+    static const int PaletteSize = 16;
+    static const int RowBytes = Width / 2;
+
+    // shapes and text share the foreground, see the notes at the top
+    unsigned char foregroundIndex, backgroundIndex;
+    unsigned int palette[PaletteSize];
+    int paletteCount;
+    // two pixels per byte, the left one in the low nibble
+    unsigned char framebuffer[RowBytes * Height];
+    // rows drawn to since the last present
+    bool dirty[Height];
+    // expanded frame, only allocated once something asks for it
+    std::vector<unsigned int> presented;
+    // both pixels of every possible framebuffer byte, for expanding without
+    // SSSE3 - rebuilt when the palette grows
+    unsigned long long pairTable[256];
+    bool pairTableValid;
+    unsigned long long pixelsWritten, stateChanges;
+    CachedText textCache[TextCacheSize];
+
+    // small ring of pending scripted touches
+    static const int TouchQueueSize = 16;
+    int touchX[TouchQueueSize], touchY[TouchQueueSize];
+    int touchHead, touchCount;
+};
+
+extern thread_local FEHLCD LCD;
+
+#endif // FEHLCD_H
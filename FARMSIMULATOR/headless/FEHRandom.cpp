@@ -0,0 +1,18 @@
+#include "FEHRandom.h"
+
+// xorshift32 state, never zero
+// one stream per thread so that parallel tools don't race on it
+static thread_local unsigned int randState = 2463534242u;
+
+int RandInt() {
+    randState ^= randState << 13;
+    randState ^= randState >> 17;
+    randState ^= randState << 5;
+    return (int) (randState >> 17);
+}
+
+void RandSeed(unsigned int seed) {
+    // mix the seed so that small consecutive seeds give unrelated streams
+    seed = seed * 2654435761u + 0x9E3779B9u;
+    randState = seed ? seed : 2463534242u;
+}
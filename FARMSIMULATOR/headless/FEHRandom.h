@@ -0,0 +1,16 @@
+#ifndef FEHRANDOM_H
+#define FEHRANDOM_H
+
+/*
+Headless FEHRandom
+Created 10/19/2026
+
+Stand-in for the firmware's random number source used by GameState.
+RandInt returns a value in [0, 32767] like the firmware version does.
+RandSeed makes runs reproducible, which the firmware can't do. The state is
+per thread, so RandSeed only affects the calling thread.
+*/
+int RandInt();
+void RandSeed(unsigned int seed);
+
+#endif // FEHRANDOM_H
@@ -1,6 +1,11 @@
 #include "FEHLCD.h"
 #include "UIElements.h"
+#include "DisplayList.h"
 //#include "GameState.h"
+#ifdef STARTUP_TIMING
+#include <chrono>
+#include <cstdio>
+#endif
 
 /**
  * Entry point to the application
@@ -8,9 +13,16 @@
  * @returns status code of program exit
  */
 int main() {
+#ifdef STARTUP_TIMING
+    // report how long it takes to get the first frame up
+    // (build with make GAMEFLAGS=-DSTARTUP_TIMING)
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
 
     // keep track of touch coordinates
     int x, y;
+    // draw commands for each frame, kept around to reuse its buffers
+    DisplayList displayList;
 
     // initialize UI elements
     initUI();
@@ -18,18 +30,29 @@ int main() {
     switchToPage(MainMenu);
     // render screen
     LCD.Clear();
-    Screen->render();
+    displayList.render(Screen);
+#ifdef STARTUP_TIMING
+    printf("first frame after %.2f ms\n",
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000);
+#endif
 
     // start program loop
     while (1) {
-        // wait for touch
-        while (!LCD.Touch(&x, &y)) {}
+        // wait for touch, building the next day while the transition
+        // screen is up and the other pages in the meantime so they're ready
+        // by the time they're needed, then freeing whatever earlier taps
+        // threw away a slice at a time
+        while (!LCD.Touch(&x, &y)) {
+            if (!buildNextDayIdle() && !prewarmUI()) UIElement::reclaim(UIElement::ReclaimSlice);
+        }
 
         // respond to touch
         if (Screen->handleClick(x, y)) {
-            // clear and re-render screen if needed
+            // clear and re-render screen if needed, skipping elements
+            // that are completely covered up and batching colors
+            // (see DisplayList.h)
             LCD.Clear();
-            Screen->render();
+            displayList.render(Screen);
         }
     }
     return 0;
@@ -0,0 +1,211 @@
+#ifndef Harness_H
+#define Harness_H
+
+/*
+Shared helpers for the headless tools
+Created 10/19/2026
+
+Everything here works on the real element tree from UIElements.h: targets are
+discovered with UIElement::getClickTargets and taps are delivered through
+Screen->handleClick, exactly like main.cpp does with real touches. Nothing is
+rendered unless a tool asks for it.
+
+This header pulls in UIElements.h, which defines the UI globals, so it can
+only be included from a single translation unit per tool.
+*/
+
+#include "UIElements.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// wall clock in seconds
+inline double nowSeconds() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// resident set size of this process in bytes, or 0 if it can't be read
+inline long residentBytes() {
+    long pages = 0, resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * 4096;
+}
+
+// first target whose label starts with prefix, or nullptr
+inline const ClickTarget* findTarget(const std::vector<ClickTarget>& targets, const char* prefix) {
+    size_t n = strlen(prefix);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (targets[i].label && strncmp(targets[i].label, prefix, n) == 0) {
+            return &targets[i];
+        }
+    }
+    return nullptr;
+}
+
+// first target with no label at all (e.g. empty plots, the transition screen)
+inline const ClickTarget* findUnlabeled(const std::vector<ClickTarget>& targets) {
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (!targets[i].label) return &targets[i];
+    }
+    return nullptr;
+}
+
+// delivers synthesized taps and counts them
+struct Tapper {
+    std::vector<ClickTarget> targets;
+    long taps = 0;
+
+    // refresh the list of targets currently on screen
+    void scan() {
+        targets.clear();
+        Screen->getClickTargets(targets);
+    }
+
+    // tap the middle of a target, returns false if there was nothing to tap
+    // (followed by one slice of reclaiming, standing in for the idle time
+    // main.cpp would have before the next touch)
+    bool tap(const ClickTarget* target) {
+        if (!target) return false;
+        ++taps;
+        Screen->handleClick(target->x, target->y);
+        UIElement::reclaim(UIElement::ReclaimSlice);
+        return true;
+    }
+};
+
+/*
+Agent policies
+
+Both policies start and finish a session on the main menu. step() performs at
+most one tap and returns false once the session is over.
+
+FarmerAgent plays sensibly: it plants the most expensive crop it can afford
+(keeping a small cash reserve for bad events) in every empty plot, harvests
+once a day, ends the day, and quits once maxDays is reached or it runs out of
+money.
+
+RandomAgent taps a uniformly random target on each step and gives up after
+maxTaps taps, which shakes out paths the farmer never takes (menus, cancel,
+planting with no money, and so on).
+*/
+struct FarmerAgent {
+    int difficulty = 0;
+    int maxDays = 30;
+    int reserve = 100;
+    bool played = false;
+    bool harvested = false;
+
+    void reset(int diff, int days) {
+        difficulty = diff;
+        maxDays = days;
+        played = false;
+        harvested = false;
+    }
+
+    // most expensive plant button that we can actually afford to plant
+    const ClickTarget* bestPlantButton(const std::vector<ClickTarget>& targets) {
+        const ClickTarget* best = nullptr;
+        int bestPrice = -1;
+        for (size_t i = 0; i < targets.size(); ++i) {
+            int price;
+            if (targets[i].label && sscanf(targets[i].label, "Plant (%d", &price) == 1) {
+                if (price + reserve < G->coins && price > bestPrice) {
+                    best = &targets[i];
+                    bestPrice = price;
+                }
+            }
+        }
+        return best;
+    }
+
+    bool hasEmptyPlot() {
+        for (int i = 0; i < NUMBER_OF_PLOTS; ++i) {
+            if (!G->plots[i].active) return true;
+        }
+        return false;
+    }
+
+    bool step(Tapper& t) {
+        t.scan();
+        if (CurrentPage == MainMenu) {
+            if (played) return false;
+            return t.tap(findTarget(t.targets, "Start"));
+        }
+        if (CurrentPage == DifficultySelection) {
+            played = true;
+            return t.tap(findTarget(t.targets, difficulty ? "Chaos Mode" : "Normal Mode"));
+        }
+        if (CurrentPage == DayTransitionScreen) {
+            return t.tap(findUnlabeled(t.targets));
+        }
+        if (CurrentPage == EventsScreen) {
+            harvested = false;
+            return t.tap(findTarget(t.targets, "Continue"));
+        }
+        if (CurrentPage == GameOverScreen) {
+            return t.tap(findTarget(t.targets, "Return to Menu"));
+        }
+        // in game
+        if (G->curr_day > maxDays) {
+            return t.tap(findTarget(t.targets, "Quit"));
+        }
+        bool canPlant = hasEmptyPlot() && bestPlantButton(t.targets);
+        if (CurrentGamePanel == PlotsPanel) {
+            if (CropToPlant) {
+                const ClickTarget* plot = findUnlabeled(t.targets);
+                return t.tap(plot ? plot : findTarget(t.targets, "Cancel"));
+            }
+            if (!harvested) {
+                harvested = true;
+                return t.tap(findTarget(t.targets, "Harvest Crops"));
+            }
+            if (canPlant && G->coins > 0) {
+                return t.tap(findTarget(t.targets, "Return"));
+            }
+            return t.tap(findTarget(t.targets, "End Day"));
+        }
+        if (canPlant) {
+            return t.tap(bestPlantButton(t.targets));
+        }
+        return t.tap(findTarget(t.targets, "View Plots"));
+    }
+};
+
+struct RandomAgent {
+    std::mt19937 rng;
+    int maxTaps = 200;
+    int tapsThisSession = 0;
+    bool played = false;
+
+    void reset(unsigned int seed, int taps) {
+        rng.seed(seed);
+        maxTaps = taps;
+        tapsThisSession = 0;
+        played = false;
+    }
+
+    bool step(Tapper& t) {
+        if (CurrentPage != MainMenu) played = true;
+        if (played && CurrentPage == MainMenu) return false;
+        if (tapsThisSession >= maxTaps) {
+            // wander back to the main menu so the next session starts clean
+            switchToPage(MainMenu);
+            return false;
+        }
+        t.scan();
+        if (t.targets.empty()) return false;
+        ++tapsThisSession;
+        std::uniform_int_distribution<size_t> pick(0, t.targets.size() - 1);
+        return t.tap(&t.targets[pick(rng)]);
+    }
+};
+
+#endif // Harness_H
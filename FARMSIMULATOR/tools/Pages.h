@@ -0,0 +1,194 @@
+#ifndef Pages_H
+#define Pages_H
+
+/*
+Page matrix for the render tools
+Created 10/19/2026
+
+Every page the game can show, with enough different game states to exercise
+all the element types: the menus, the game menu with empty, mixed, ready and
+full plots (home panel, view mode and plant mode), the day transition, the
+events screen for no event, every single event and every pair of events, and
+the game over screen, and the history page with no days and with more days
+than fit on the chart. One extra case isn't a game page: white text drawn
+after a differently colored fill in the same batch, which the LCD's single
+foreground color makes easy to get wrong.
+
+setupPageCase builds a fresh session on the calling thread and brings up the
+page for one case. Game state is set up directly rather than by playing, so
+nothing depends on the random number stream and the same case always draws
+the same frame.
+
+Like Harness.h, this pulls in UIElements.h, so it can only be included from
+a single translation unit per tool.
+*/
+
+#include "UIElements.h"
+
+#include <string>
+#include <vector>
+
+// page setups
+#define CASE_MAIN_MENU 0
+#define CASE_CREDITS 1
+#define CASE_INSTRUCTIONS 2
+#define CASE_STATISTICS 3
+#define CASE_DIFFICULTY 4
+#define CASE_HOME 5
+#define CASE_PLOTS 6
+#define CASE_PLANT_MODE 7
+#define CASE_TRANSITION 8
+#define CASE_EVENTS 9
+#define CASE_GAME_OVER 10
+#define CASE_HISTORY 11
+#define CASE_TEXT_AFTER_FILL 12
+
+// plot layouts for CASE_HOME, CASE_PLOTS and CASE_PLANT_MODE
+#define PLOTS_EMPTY 0
+#define PLOTS_MIXED 1
+#define PLOTS_READY 2
+#define PLOTS_FULL 3
+
+struct page_case_raw {
+    std::string name;
+    int kind;
+    int a, b; // plot layout, or the two events (-1 for none)
+} typedef page_case;
+
+
+inline std::vector<page_case> buildPageCases() {
+    std::vector<page_case> cases;
+    cases.push_back(page_case{"main_menu", CASE_MAIN_MENU, 0, 0});
+    cases.push_back(page_case{"credits", CASE_CREDITS, 0, 0});
+    cases.push_back(page_case{"instructions", CASE_INSTRUCTIONS, 0, 0});
+    cases.push_back(page_case{"statistics", CASE_STATISTICS, 0, 0});
+    cases.push_back(page_case{"history_empty", CASE_HISTORY, 0, 0});
+    cases.push_back(page_case{"history", CASE_HISTORY, 40, 0});
+    cases.push_back(page_case{"difficulty", CASE_DIFFICULTY, 0, 0});
+
+    const char* layouts[4] = {"empty", "mixed", "ready", "full"};
+    for (int layout = 0; layout < 4; ++layout) {
+        cases.push_back(page_case{std::string("home_") + layouts[layout], CASE_HOME, layout, 0});
+        cases.push_back(page_case{std::string("plots_") + layouts[layout], CASE_PLOTS, layout, 0});
+    }
+    cases.push_back(page_case{"plant_mode_empty", CASE_PLANT_MODE, PLOTS_EMPTY, 0});
+    cases.push_back(page_case{"plant_mode_mixed", CASE_PLANT_MODE, PLOTS_MIXED, 0});
+    cases.push_back(page_case{"transition", CASE_TRANSITION, 0, 0});
+
+    // every combination of up to two events
+    char name[32];
+    cases.push_back(page_case{"events_none", CASE_EVENTS, -1, -1});
+    for (int i = 0; i < 10; ++i) {
+        snprintf(name, sizeof(name), "events_%d", i);
+        cases.push_back(page_case{name, CASE_EVENTS, i, -1});
+    }
+    for (int i = 0; i < 10; ++i) {
+        for (int j = i + 1; j < 10; ++j) {
+            snprintf(name, sizeof(name), "events_%d_%d", i, j);
+            cases.push_back(page_case{name, CASE_EVENTS, i, j});
+        }
+    }
+    cases.push_back(page_case{"game_over", CASE_GAME_OVER, 0, 0});
+    cases.push_back(page_case{"text_after_fill", CASE_TEXT_AFTER_FILL, 0, 0});
+    return cases;
+}
+
+// plant the farm for one of the plot layouts
+inline void setupPlots(int layout) {
+    crop_type crops[4] = {carrot, tomato, corn, lettuce};
+    G->coins = 100000;
+    if (layout == PLOTS_MIXED) {
+        // a few crops at different stages, some already ready
+        for (int i = 0; i < 8; ++i) {
+            G->plant(&G->plots[(i * 5) % NUMBER_OF_PLOTS], &crops[i % 4]);
+            G->curr_day++;
+        }
+    }
+    else if (layout == PLOTS_READY) {
+        for (int i = 0; i < NUMBER_OF_PLOTS; i += 2) G->plant(&G->plots[i], &crops[(i / 2) % 4]);
+        G->curr_day += 10;
+    }
+    else if (layout == PLOTS_FULL) {
+        for (int i = 0; i < NUMBER_OF_PLOTS; ++i) G->plant(&G->plots[i], &crops[i % 4]);
+        G->curr_day += 1;
+    }
+    G->coins = 1234;
+}
+
+// build a fresh session on this thread and bring up the page for one case
+inline void setupPageCase(const page_case& c) {
+    CropToPlant = nullptr;
+    initUI();
+    switchToPage(MainMenu);
+
+    switch (c.kind) {
+    case CASE_MAIN_MENU:
+        break;
+    case CASE_CREDITS:
+        switchToPage(CreditsPage);
+        break;
+    case CASE_INSTRUCTIONS:
+        switchToPage(InstructionsPage);
+        break;
+    case CASE_STATISTICS:
+        switchToPage(getStatisticsPage());
+        break;
+    case CASE_DIFFICULTY:
+        switchToPage(DifficultySelection);
+        break;
+    case CASE_HOME:
+    case CASE_PLOTS:
+    case CASE_PLANT_MODE:
+        playGame(0);
+        setupPlots(c.a);
+        if (c.kind == CASE_PLANT_MODE) {
+            CropToPlant = (crop_type*) malloc(sizeof(crop_type));
+            *CropToPlant = corn;
+        }
+        updatePlots();
+        if (c.kind != CASE_HOME) switchToPanel(PlotsPanel);
+        break;
+    case CASE_TRANSITION:
+        playGame(0);
+        G->curr_day = 12;
+        switchToPage(DayTransitionScreen);
+        break;
+    case CASE_EVENTS:
+        playGame(0);
+        for (int i = 0; i < 10; ++i) G->event_occurred[i] = (i == c.a || i == c.b);
+        *EventsScreen = getEventsScreen();
+        switchToPage(EventsScreen);
+        break;
+    case CASE_HISTORY:
+        // a made-up run of c.a days, alternating sunny days and floods
+        playGame(0);
+        for (int day = 1; day <= c.a; ++day) {
+            int delta = (day % 3 == 0) ? -G->events[0].moneyAmount : (day * 37) % 200;
+            G->coins += delta;
+            G->history.append(day_record{day, G->coins, delta,
+                                         (uint16_t) (day % 3 == 0 ? 1 << 0 : 1 << 3), 0, 0, 0});
+        }
+        switchToPage(getHistoryPage());
+        break;
+    case CASE_GAME_OVER:
+        playGame(0);
+        G->curr_day = 23;
+        G->coins = 0;
+        switchToPage(GameOverScreen);
+        break;
+    case CASE_TEXT_AFTER_FILL: {
+        // the blue rectangle covers the first white label, so it lands in
+        // the same batch layer as the white label on the green rectangle
+        // and gets drawn just before it
+        UIElement* page = new UIElement;
+        page->addChild(new RectangleElement(20, 40, 280, 60, FEHLCD::Green));
+        page->addChild(new StringElement(20, 120, "Under the blue", FEHLCD::White));
+        page->addChild(new StringElement(30, 60, "White on green", FEHLCD::White));
+        page->addChild(new RectangleElement(20, 130, 120, 40, FEHLCD::Blue));
+        switchToPage(page);
+        break;
+    }
+    }
+}
+
+#endif // Pages_H
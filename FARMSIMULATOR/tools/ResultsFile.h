@@ -0,0 +1,434 @@
+#ifndef ResultsFile_H
+#define ResultsFile_H
+
+/*
+Columnar results file for the simulation tools
+Created 10/19/2026
+
+One row per simulated game (seed, difficulty, days survived, final coins,
+money earned and lost, crops planted of each type and events of each type),
+stored a column at a time so that a query only reads the columns it needs.
+
+Layout, all little endian:
+
+  "FARMRES1"
+  chunk 0: column 0 bytes, column 1 bytes, ... column N-1 bytes
+  chunk 1: ...
+  padding to a multiple of 8
+  footer: column names, then one results_chunk_meta per chunk
+  results_trailer
+
+Each chunk holds up to RESULTS_CHUNK_ROWS rows. Every column of every chunk
+is encoded on its own, whichever way comes out smallest: constant (nothing
+stored, the value is the chunk's min), zigzag varints of the values, or
+zigzag varints of the differences from the previous value (for the seeds,
+which mostly count up). The footer records where each one is and its min,
+max and sum, so summaries come from the footer alone and a filter can skip
+or take whole chunks without decoding them.
+
+ResultsWriter is filled from the simulation threads: each one fills a chunk
+of plain rows and submits it, and a background thread encodes and writes
+the chunks while the simulation goes on. ResultsReader maps the file and
+decodes columns straight out of the mapping, a batch of values at a time,
+so nothing is read into memory first and columns that aren't scanned are
+never touched.
+
+Like the rest of the tools this uses POSIX calls, so it's kept out of the
+game build.
+*/
+
+#include "StatsAggregator.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Rows per chunk, and how many full chunks can wait for the writer thread
+// before the simulation threads have to wait for it
+#define RESULTS_CHUNK_ROWS 16384
+#define RESULTS_QUEUE_LIMIT 8
+// Values decoded at a time by ResultsReader::scan
+#define RESULTS_SCAN_BATCH 1024
+#define RESULTS_NAME_LENGTH 24
+
+// Columns
+#define RESULTS_SEED 0
+#define RESULTS_DIFFICULTY 1
+#define RESULTS_DAYS 2
+#define RESULTS_FINAL_COINS 3
+#define RESULTS_MONEY_EARNED 4
+#define RESULTS_MONEY_LOST 5
+// crops planted of type c (1 to NUMBER_OF_CROP_TYPES - 1)
+#define RESULTS_CROPS_PLANTED(c) (5 + (c))
+// times event i fired
+#define RESULTS_EVENTS(i) (RESULTS_CROPS_PLANTED(NUMBER_OF_CROP_TYPES) + (i))
+#define RESULTS_COLUMNS RESULTS_EVENTS(NUMBER_OF_EVENT_TYPES)
+
+// Column encodings
+#define RESULTS_CONSTANT 0
+#define RESULTS_VARINT 1
+#define RESULTS_DELTA 2
+
+static const char resultsColumnNames[RESULTS_COLUMNS][RESULTS_NAME_LENGTH] = {
+    "seed", "difficulty", "days", "final_coins", "money_earned", "money_lost",
+    "carrots_planted", "tomatoes_planted", "corn_planted", "lettuce_planted",
+    "flood", "tornado", "fire", "sunny_day", "thief",
+    "rain", "bug", "fertilizer", "pandemic", "mystery"
+};
+
+// Where one column of one chunk is and what's in it
+struct results_column_meta_raw {
+    uint64_t offset; // from the start of the file
+    uint32_t bytes;
+    uint32_t encoding;
+    int64_t min, max, sum;
+} typedef results_column_meta;
+
+struct results_chunk_meta_raw {
+    uint64_t rows;
+    results_column_meta columns[RESULTS_COLUMNS];
+} typedef results_chunk_meta;
+
+// Last bytes of the file
+struct results_trailer_raw {
+    uint64_t footer_offset;
+    uint64_t chunks;
+    uint64_t columns;
+    uint64_t rows;
+    char magic[8];
+} typedef results_trailer;
+
+static_assert(sizeof(results_column_meta) == 40, "results_column_meta is written as is");
+static_assert(sizeof(results_trailer) == 40, "results_trailer is written as is");
+
+// Rows on their way to the writer, one array per column
+struct results_chunk {
+    int rows = 0;
+    int64_t values[RESULTS_COLUMNS][RESULTS_CHUNK_ROWS];
+
+    bool full() const { return rows == RESULTS_CHUNK_ROWS; }
+    void append(const int64_t* row) {
+        for (int c = 0; c < RESULTS_COLUMNS; c++) values[c][rows] = row[c];
+        rows++;
+    }
+};
+
+inline uint64_t resultsZigzag(int64_t value) {
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+inline int64_t resultsUnzigzag(uint64_t value) {
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+inline void resultsPutVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t) (value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t) value);
+}
+
+/*
+Background writer
+
+open starts the writer thread. Simulation threads get an empty chunk from
+take_chunk, append rows to it, and submit it once it's full (or at the end,
+however full it is); submit only waits if RESULTS_QUEUE_LIMIT chunks are
+already queued. Chunks are recycled, so after the first few nothing is
+allocated. close waits for the queue to drain and writes the footer, and
+returns false if anything failed to write.
+*/
+struct ResultsWriter {
+    FILE* file = nullptr;
+    bool failed = false;
+    uint64_t position = 0;
+    uint64_t rows = 0;
+    std::vector<results_chunk_meta> metas;
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<results_chunk*> queue; // oldest first
+    std::vector<results_chunk*> spare;
+    bool closing = false;
+    std::thread thread;
+
+    ~ResultsWriter() {
+        close();
+        for (size_t i = 0; i < spare.size(); i++) delete spare[i];
+    }
+
+    bool open(const char* path) {
+        file = fopen(path, "wb");
+        if (!file) return false;
+        failed = false;
+        position = 0;
+        rows = 0;
+        metas.clear();
+        closing = false;
+        write("FARMRES1", 8);
+        thread = std::thread(&ResultsWriter::run, this);
+        return true;
+    }
+
+    results_chunk* take_chunk() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (spare.empty()) return new results_chunk;
+        results_chunk* chunk = spare.back();
+        spare.pop_back();
+        return chunk;
+    }
+
+    void submit(results_chunk* chunk) {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this] { return queue.size() < RESULTS_QUEUE_LIMIT; });
+        queue.push_back(chunk);
+        changed.notify_all();
+    }
+
+    bool close() {
+        if (!file) return true;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closing = true;
+            changed.notify_all();
+        }
+        thread.join();
+
+        // footer, 8 byte aligned so the reader can use it in place
+        static const char zeros[8] = {};
+        write(zeros, (size_t) (-position & 7));
+        results_trailer trailer;
+        trailer.footer_offset = position;
+        trailer.chunks = metas.size();
+        trailer.columns = RESULTS_COLUMNS;
+        trailer.rows = rows;
+        memcpy(trailer.magic, "FARMEND1", 8);
+        write(resultsColumnNames, sizeof(resultsColumnNames));
+        write(metas.data(), metas.size() * sizeof(results_chunk_meta));
+        write(&trailer, sizeof(trailer));
+        if (fclose(file) != 0) failed = true;
+        file = nullptr;
+        return !failed;
+    }
+
+    void write(const void* data, size_t bytes) {
+        if (bytes && fwrite(data, 1, bytes, file) != bytes) failed = true;
+        position += bytes;
+    }
+
+    // writer thread, encodes and writes chunks until closed
+    void run() {
+        std::vector<uint8_t> plain, delta;
+        while (true) {
+            results_chunk* chunk;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                changed.wait(guard, [this] { return !queue.empty() || closing; });
+                if (queue.empty()) return;
+                chunk = queue.front();
+                queue.pop_front();
+                changed.notify_all();
+            }
+            if (chunk->rows > 0) encode(chunk, plain, delta);
+            chunk->rows = 0;
+            std::lock_guard<std::mutex> guard(lock);
+            spare.push_back(chunk);
+        }
+    }
+
+    void encode(const results_chunk* chunk, std::vector<uint8_t>& plain, std::vector<uint8_t>& delta) {
+        results_chunk_meta meta;
+        meta.rows = chunk->rows;
+        for (int c = 0; c < RESULTS_COLUMNS; c++) {
+            const int64_t* values = chunk->values[c];
+            results_column_meta& column = meta.columns[c];
+            column.min = column.max = values[0];
+            column.sum = 0;
+            plain.clear();
+            delta.clear();
+            int64_t previous = 0;
+            for (int r = 0; r < chunk->rows; r++) {
+                int64_t v = values[r];
+                if (v < column.min) column.min = v;
+                if (v > column.max) column.max = v;
+                column.sum += v;
+                resultsPutVarint(plain, resultsZigzag(v));
+                resultsPutVarint(delta, resultsZigzag(v - previous));
+                previous = v;
+            }
+            const std::vector<uint8_t>* bytes = &plain;
+            column.encoding = RESULTS_VARINT;
+            if (column.min == column.max) {
+                bytes = nullptr;
+                column.encoding = RESULTS_CONSTANT;
+            } else if (delta.size() < plain.size()) {
+                bytes = &delta;
+                column.encoding = RESULTS_DELTA;
+            }
+            column.offset = position;
+            column.bytes = bytes ? (uint32_t) bytes->size() : 0;
+            if (bytes) write(bytes->data(), bytes->size());
+        }
+        metas.push_back(meta);
+        rows += chunk->rows;
+    }
+};
+
+/*
+Memory mapped reader
+
+open maps the whole file and checks the trailer; the footer is used where
+it lies in the mapping. scan calls visit(const int64_t* values, int count)
+with the values of one column in row order, RESULTS_SCAN_BATCH at a time,
+decoded into a buffer on the stack. scan_chunk does the same for a single
+chunk, for callers that pick chunks from their footer stats first. Both
+return false if a column's bytes run out before its rows do (a corrupt
+file); decoding never reads past the bytes the footer gives the column.
+A reader owns its mapping, so it can't be copied.
+*/
+struct ResultsReader {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    const results_trailer* trailer = nullptr;
+    const char (*names)[RESULTS_NAME_LENGTH] = nullptr;
+    const results_chunk_meta* metas = nullptr;
+
+    ResultsReader() {}
+    ResultsReader(const ResultsReader&) = delete;
+    ResultsReader& operator=(const ResultsReader&) = delete;
+    ~ResultsReader() { close(); }
+
+    bool open(const char* path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t) (8 + sizeof(results_trailer))) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+        data = (const uint8_t*) mapped;
+        size = (size_t) info.st_size;
+
+        trailer = (const results_trailer*) (data + size - sizeof(results_trailer));
+        uint64_t footer = trailer->footer_offset;
+        if (trailer->chunks > size / sizeof(results_chunk_meta)) {
+            close();
+            return false;
+        }
+        uint64_t footerBytes = sizeof(resultsColumnNames) + trailer->chunks * sizeof(results_chunk_meta);
+        if (memcmp(data, "FARMRES1", 8) != 0 || memcmp(trailer->magic, "FARMEND1", 8) != 0 ||
+            trailer->columns != RESULTS_COLUMNS || (footer & 7) ||
+            footer + footerBytes + sizeof(results_trailer) != size) {
+            close();
+            return false;
+        }
+        names = (const char (*)[RESULTS_NAME_LENGTH]) (data + footer);
+        metas = (const results_chunk_meta*) (data + footer + sizeof(resultsColumnNames));
+        for (uint64_t chunk = 0; chunk < trailer->chunks; chunk++) {
+            if (metas[chunk].rows > RESULTS_CHUNK_ROWS) {
+                close();
+                return false;
+            }
+            for (int c = 0; c < RESULTS_COLUMNS; c++) {
+                const results_column_meta& m = metas[chunk].columns[c];
+                if (m.encoding > RESULTS_DELTA || m.offset + m.bytes > footer) {
+                    close();
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void close() {
+        if (data) munmap((void*) data, size);
+        data = nullptr;
+        size = 0;
+        trailer = nullptr;
+        names = nullptr;
+        metas = nullptr;
+    }
+
+    long long rows() const { return (long long) trailer->rows; }
+    int chunks() const { return (int) trailer->chunks; }
+
+    // column number from its name, -1 if there's no such column
+    int column(const char* name) const {
+        for (int c = 0; c < RESULTS_COLUMNS; c++) {
+            if (!strncmp(names[c], name, RESULTS_NAME_LENGTH)) return c;
+        }
+        return -1;
+    }
+
+    const results_column_meta& meta(int chunk, int column) const {
+        return metas[chunk].columns[column];
+    }
+
+    template <typename Visit>
+    bool scan_chunk(int chunk, int column, Visit visit) const {
+        const results_column_meta& m = meta(chunk, column);
+        int64_t batch[RESULTS_SCAN_BATCH];
+        int left = (int) metas[chunk].rows;
+        if (m.encoding == RESULTS_CONSTANT) {
+            for (int i = 0; i < RESULTS_SCAN_BATCH; i++) batch[i] = m.min;
+            while (left > 0) {
+                int n = left < RESULTS_SCAN_BATCH ? left : RESULTS_SCAN_BATCH;
+                visit((const int64_t*) batch, n);
+                left -= n;
+            }
+            return true;
+        }
+        const uint8_t* p = data + m.offset;
+        const uint8_t* end = p + m.bytes;
+        bool isDelta = m.encoding == RESULTS_DELTA;
+        int64_t previous = 0;
+        while (left > 0) {
+            int n = left < RESULTS_SCAN_BATCH ? left : RESULTS_SCAN_BATCH;
+            for (int i = 0; i < n; i++) {
+                // most values fit in one byte
+                if (p == end) return false;
+                uint64_t value = *p++;
+                if (value & 0x80) {
+                    value &= 0x7f;
+                    int shift = 7;
+                    uint8_t b;
+                    do {
+                        if (p == end || shift > 63) return false;
+                        b = *p++;
+                        value |= (uint64_t) (b & 0x7f) << shift;
+                        shift += 7;
+                    } while (b & 0x80);
+                }
+                int64_t v = resultsUnzigzag(value);
+                if (isDelta) v = previous += v;
+                batch[i] = v;
+            }
+            visit((const int64_t*) batch, n);
+            left -= n;
+        }
+        return true;
+    }
+
+    template <typename Visit>
+    bool scan(int column, Visit visit) const {
+        for (int chunk = 0; chunk < chunks(); chunk++) {
+            if (!scan_chunk(chunk, column, visit)) return false;
+        }
+        return true;
+    }
+};
+
+#endif // ResultsFile_H
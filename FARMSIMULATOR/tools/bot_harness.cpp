@@ -0,0 +1,101 @@
+#include "Harness.h"
+#include "FEHRandom.h"
+
+/*
+Headless bot harness
+Created 10/19/2026
+
+Plays full sessions through the real UI tree (main menu -> difficulty ->
+game menu -> end day -> transition -> news -> ... -> quit or game over) by
+synthesizing taps into Screen->handleClick. Rendering is skipped entirely,
+so what's measured is the cost of the UI wiring plus the game logic.
+
+usage: bot_harness [--policy farmer|random] [--sessions N] [--days N]
+                   [--taps N] [--seed N]
+
+Reports sessions/sec, taps/sec, and resident memory once the run has warmed
+up and at the end, so that per-session leaks show up as growth, along with how
+many elements are still alive at the end.
+*/
+
+int main(int argc, char** argv) {
+    // defaults
+    const char* policy = "farmer";
+    long sessions = 2000;
+    int maxDays = 30;
+    int maxTaps = 200;
+    unsigned int seed = 1;
+
+    // parse arguments
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--policy")) policy = argv[i+1];
+        else if (!strcmp(argv[i], "--sessions")) sessions = atol(argv[i+1]);
+        else if (!strcmp(argv[i], "--days")) maxDays = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--taps")) maxTaps = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--seed")) seed = (unsigned int) atol(argv[i+1]);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    bool random = !strcmp(policy, "random");
+    if (!random && strcmp(policy, "farmer")) {
+        fprintf(stderr, "unknown policy %s\n", policy);
+        return 1;
+    }
+
+    // same setup as main.cpp, minus the rendering
+    RandSeed(seed);
+    initUI();
+    switchToPage(MainMenu);
+
+    Tapper tapper;
+    FarmerAgent farmer;
+    RandomAgent randomAgent;
+    long days = 0;
+    long warmup = sessions / 10;
+    long warmRss = residentBytes();
+    long warmTaps = 0;
+    double start = nowSeconds(), warmStart = start;
+
+    for (long s = 0; s < sessions; ++s) {
+        if (s == warmup) {
+            warmRss = residentBytes();
+            warmTaps = tapper.taps;
+            warmStart = nowSeconds();
+        }
+        if (random) {
+            randomAgent.reset(seed + (unsigned int) s, maxTaps);
+            while (randomAgent.step(tapper)) {}
+        }
+        else {
+            farmer.reset((int) (s & 1), maxDays);
+            while (farmer.step(tapper)) {}
+        }
+        days += G->curr_day;
+    }
+
+    double end = nowSeconds();
+    long endRss = residentBytes();
+    double steadyTime = end - warmStart;
+    long steadySessions = sessions - warmup;
+
+    printf("policy:          %s\n", policy);
+    printf("sessions:        %ld\n", sessions);
+    printf("taps:            %ld\n", tapper.taps);
+    printf("days played:     %ld\n", days);
+    printf("elapsed:         %.3f s\n", end - start);
+    if (steadyTime > 0) {
+        printf("sessions/sec:    %.0f\n", steadySessions / steadyTime);
+        printf("taps/sec:        %.0f\n", (tapper.taps - warmTaps) / steadyTime);
+    }
+    printf("rss after warmup: %ld KiB\n", warmRss / 1024);
+    printf("rss at end:       %ld KiB\n", endRss / 1024);
+    printf("live elements:    %ld (%d waiting to be freed)\n", UIElement::liveElements(),
+           UIElement::discardedElements());
+    if (steadySessions > 0) {
+        printf("rss growth:       %.1f bytes/session\n", (double) (endRss - warmRss) / steadySessions);
+    }
+    PERF_REPORT(stdout);
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "GameState.h"
+#include "FEHRandom.h"
+#include "PerfCounters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+Large farm benchmark
+Created 10/19/2026
+
+Runs GameState directly (no UI) on a farm with a configurable number of plots
+and a configurable number of them kept occupied, and reports the cost of a
+simulated day: new_day (including the random event and its wipeouts) plus
+harvest_all and replanting to keep occupancy steady. With the active set the
+cost should follow the occupied count, not the farm size.
+
+With --fast-forward 1 it instead measures GameState::fast_forward on fresh
+games (harvest and replant carrots), starting a new game whenever the last
+one goes broke, and reports simulated days per second.
+
+usage: farm_bench [--plots N] [--occupied N] [--days N] [--seed N]
+                  [--fast-forward 0|1] [--difficulty 0|1]
+*/
+
+int main(int argc, char** argv) {
+    int numPlots = 1000000;
+    int occupied = 1000;
+    int days = 100000;
+    unsigned int seed = 1;
+    int fastForward = 0;
+    int difficulty = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--plots")) numPlots = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--occupied")) occupied = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--days")) days = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--seed")) seed = (unsigned int) atol(argv[i+1]);
+        else if (!strcmp(argv[i], "--fast-forward")) fastForward = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--difficulty")) difficulty = atoi(argv[i+1]);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (occupied > numPlots) occupied = numPlots;
+
+    RandSeed(seed);
+    crop_type crop = carrot;
+
+    if (fastForward) {
+        long long simulated = 0, games = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (simulated < days) {
+            GameState game(difficulty, numPlots);
+            ff_result r = game.fast_forward((int) (days - simulated), FF_HARVEST_AND_REPLANT, &crop);
+            // count the day a game ends on even if nothing got simulated
+            simulated += r.days ? r.days : 1;
+            games++;
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("plots:        %d\n", numPlots);
+        printf("games:        %lld\n", games);
+        printf("days:         %lld\n", simulated);
+        printf("elapsed:      %.3f s\n", elapsed);
+        printf("days/sec:     %.0f\n", simulated / elapsed);
+        PERF_REPORT(stdout);
+        return 0;
+    }
+
+    GameState game(0, numPlots);
+
+    // spread plantings evenly over the farm
+    long long stride = numPlots / (occupied ? occupied : 1);
+    int next = 0;
+    long long planted = 0, harvested = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int day = 0; day < days; day++) {
+        // keep the game alive and the farm topped up
+        game.coins = 1 << 30;
+        while (game.active_plots() < occupied) {
+            game.plant(&game.plots[(int) ((next++ * stride) % numPlots)], &crop);
+            planted++;
+        }
+        game.new_day();
+        harvested += game.harvest_all().changed.size();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("plots:        %d\n", numPlots);
+    printf("occupied:     %d\n", occupied);
+    printf("days:         %d\n", days);
+    printf("planted:      %lld\n", planted);
+    printf("harvested:    %lld\n", harvested);
+    printf("elapsed:      %.3f s\n", elapsed);
+    printf("ns/day:       %.1f\n", elapsed * 1e9 / days);
+    printf("days/sec:     %.0f\n", days / elapsed);
+    PERF_REPORT(stdout);
+    return 0;
+}
@@ -0,0 +1,299 @@
+#include "Harness.h"
+#include "Pages.h"
+#include "DisplayList.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+Golden image render check
+Created 10/19/2026
+
+Renders every page of the game into the headless framebuffer and compares
+each frame pixel for pixel against a stored golden image, so that rendering
+optimizations can be checked for changed output before they go in.
+
+The pages are the matrix in Pages.h. Frames are drawn with a DisplayList like
+main.cpp does, or with --render culled or plain using renderVisible or the
+plain recursive render; all three must match the same golden images.
+
+Cases are spread over worker threads (all UI globals and the LCD are per
+thread). Each worker renders its case and diffs it against the golden image
+in 16x16 tiles, four pixels per SSE2 compare. Mismatched cases list the tiles
+that changed, and the actual frame plus a difference mask are written as PPM
+images to the dump directory for a closer look.
+
+Golden images are run-length encoded in tools/golden/<case>.rle:
+  "FSG1", width and height as 16-bit values, palette size minus one as a
+  byte, the palette colors as 32-bit values (all little-endian), then one
+  (varint run length, palette index byte) pair per run of equal pixels.
+
+usage: golden [--update 1] [--dir tools/golden] [--dump build/golden_diff]
+              [--threads N] [--filter prefix]
+              [--render batched|culled|plain]
+*/
+
+#define TILE_SIZE 16
+#define TILES_X (FEHLCD::Width / TILE_SIZE)
+#define TILES_Y (FEHLCD::Height / TILE_SIZE)
+#define FRAME_PIXELS (FEHLCD::Width * FEHLCD::Height)
+
+struct case_result_raw {
+    bool missing;
+    bool written;
+    int mismatched;
+    int bbox[4];
+    int tiles[TILES_Y][TILES_X];
+} typedef case_result;
+
+// golden image files
+static void put32(std::vector<unsigned char>& out, unsigned int v) {
+    for (int i = 0; i < 4; ++i) out.push_back((unsigned char) (v >> (8 * i)));
+}
+static unsigned int get32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24);
+}
+// 7 bits per byte, high bit set on all but the last byte
+static void putVarint(std::vector<unsigned char>& out, unsigned int v) {
+    while (v >= 0x80) {
+        out.push_back((unsigned char) (v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((unsigned char) v);
+}
+static bool getVarint(const std::vector<unsigned char>& in, size_t* pos, unsigned int* v) {
+    *v = 0;
+    for (int shift = 0; shift < 35 && *pos < in.size(); shift += 7) {
+        unsigned char byte = in[(*pos)++];
+        *v |= (unsigned int) (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool writeGolden(const std::string& path, const unsigned int* pixels) {
+    // pages only use a handful of colors, so runs store a palette index
+    std::vector<unsigned int> palette;
+    std::vector<unsigned char> runs;
+    int i = 0;
+    while (i < FRAME_PIXELS) {
+        int run = 1;
+        while (i + run < FRAME_PIXELS && pixels[i + run] == pixels[i]) ++run;
+        int index = 0;
+        while (index < (int) palette.size() && palette[index] != pixels[i]) ++index;
+        if (index == (int) palette.size()) {
+            if (index == 256) return false;
+            palette.push_back(pixels[i]);
+        }
+        putVarint(runs, (unsigned int) run);
+        runs.push_back((unsigned char) index);
+        i += run;
+    }
+
+    std::vector<unsigned char> out;
+    out.push_back('F'); out.push_back('S'); out.push_back('G'); out.push_back('1');
+    out.push_back(FEHLCD::Width & 0xFF); out.push_back(FEHLCD::Width >> 8);
+    out.push_back(FEHLCD::Height & 0xFF); out.push_back(FEHLCD::Height >> 8);
+    out.push_back((unsigned char) (palette.size() - 1));
+    for (size_t k = 0; k < palette.size(); ++k) put32(out, palette[k]);
+    out.insert(out.end(), runs.begin(), runs.end());
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    return fclose(f) == 0 && ok;
+}
+
+static bool readGolden(const std::string& path, unsigned int* pixels) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<unsigned char> in;
+    unsigned char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) in.insert(in.end(), buffer, buffer + n);
+    fclose(f);
+
+    if (in.size() < 9 || memcmp(in.data(), "FSG1", 4)) return false;
+    if ((in[4] | (in[5] << 8)) != FEHLCD::Width || (in[6] | (in[7] << 8)) != FEHLCD::Height) return false;
+    size_t colors = in[8] + 1, pos = 9;
+    if (in.size() < pos + 4 * colors) return false;
+    unsigned int palette[256];
+    for (size_t k = 0; k < colors; ++k, pos += 4) palette[k] = get32(&in[pos]);
+
+    int filled = 0;
+    while (pos < in.size()) {
+        unsigned int run;
+        if (!getVarint(in, &pos, &run) || pos >= in.size() || in[pos] >= colors) return false;
+        if (run > (unsigned int) (FRAME_PIXELS - filled)) return false;
+        unsigned int color = palette[in[pos++]];
+        for (unsigned int k = 0; k < run; ++k) pixels[filled++] = color;
+    }
+    return filled == FRAME_PIXELS;
+}
+
+// count mismatched pixels per 16x16 tile, returns the total
+static int diffFrames(const unsigned int* expected, const unsigned int* actual, case_result* r) {
+    int total = 0;
+    r->bbox[0] = FEHLCD::Width; r->bbox[1] = FEHLCD::Height; r->bbox[2] = -1; r->bbox[3] = -1;
+    for (int y = 0; y < FEHLCD::Height; ++y) {
+        const unsigned int* e = expected + y * FEHLCD::Width;
+        const unsigned int* a = actual + y * FEHLCD::Width;
+        int* tileRow = r->tiles[y / TILE_SIZE];
+        for (int x = 0; x < FEHLCD::Width; x += 4) {
+#ifdef __SSE2__
+            __m128i same = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*) (e + x)),
+                                           _mm_loadu_si128((const __m128i*) (a + x)));
+            int differ = ~_mm_movemask_ps(_mm_castsi128_ps(same)) & 0xF;
+#else
+            int differ = 0;
+            for (int k = 0; k < 4; ++k) differ |= (e[x + k] != a[x + k]) << k;
+#endif
+            if (!differ) continue;
+            int count = __builtin_popcount(differ);
+            tileRow[x / TILE_SIZE] += count;
+            total += count;
+            int first = x + __builtin_ctz(differ), last = x + 31 - __builtin_clz(differ);
+            if (first < r->bbox[0]) r->bbox[0] = first;
+            if (last > r->bbox[2]) r->bbox[2] = last;
+            if (y < r->bbox[1]) r->bbox[1] = y;
+            r->bbox[3] = y;
+        }
+    }
+    return total;
+}
+
+// actual frame, and the difference mask (mismatches in red over a dimmed frame)
+static void writePPM(const std::string& path, const unsigned int* pixels) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return;
+    fprintf(f, "P6\n%d %d\n255\n", FEHLCD::Width, FEHLCD::Height);
+    for (int i = 0; i < FRAME_PIXELS; ++i) {
+        unsigned char rgb[3] = {(unsigned char) (pixels[i] >> 16), (unsigned char) (pixels[i] >> 8), (unsigned char) pixels[i]};
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+}
+static void dumpMismatch(const std::string& dir, const std::string& name, const unsigned int* expected, const unsigned int* actual) {
+    std::vector<unsigned int> mask(FRAME_PIXELS);
+    for (int i = 0; i < FRAME_PIXELS; ++i) {
+        mask[i] = expected[i] != actual[i] ? 0xFF0000u : (actual[i] >> 2) & 0x3F3F3Fu;
+    }
+    writePPM(dir + "/" + name + ".actual.ppm", actual);
+    writePPM(dir + "/" + name + ".diff.ppm", mask.data());
+}
+
+struct golden_options_raw {
+    bool update;
+    std::string render;
+    std::string dir;
+    std::string dump;
+} typedef golden_options;
+
+static thread_local DisplayList displayList;
+
+static void worker(const std::vector<page_case>* cases, std::vector<case_result>* results,
+                   std::atomic<int>* next, const golden_options* opt) {
+    std::vector<unsigned int> expected(FRAME_PIXELS);
+    int index;
+    while ((index = next->fetch_add(1)) < (int) cases->size()) {
+        const page_case& c = (*cases)[index];
+        case_result& r = (*results)[index];
+        memset(&r, 0, sizeof(r));
+
+        setupPageCase(c);
+        LCD.Clear();
+        if (opt->render == "plain") Screen->render();
+        else if (opt->render == "culled") Screen->renderVisible();
+        else displayList.render(Screen);
+        const unsigned int* actual = LCD.Pixels();
+
+        std::string path = opt->dir + "/" + c.name + ".rle";
+        if (opt->update) {
+            r.written = writeGolden(path, actual);
+            continue;
+        }
+        if (!readGolden(path, expected.data())) {
+            r.missing = true;
+            continue;
+        }
+        r.mismatched = diffFrames(expected.data(), actual, &r);
+        if (r.mismatched) dumpMismatch(opt->dump, c.name, expected.data(), actual);
+    }
+}
+
+int main(int argc, char** argv) {
+    golden_options opt = golden_options{false, "batched", "tools/golden", "build/golden_diff"};
+    int threads = (int) std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    std::string filter;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--update")) opt.update = atoi(argv[i+1]) != 0;
+        else if (!strcmp(argv[i], "--render")) opt.render = argv[i+1];
+        else if (!strcmp(argv[i], "--dir")) opt.dir = argv[i+1];
+        else if (!strcmp(argv[i], "--dump")) opt.dump = argv[i+1];
+        else if (!strcmp(argv[i], "--threads")) threads = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--filter")) filter = argv[i+1];
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<page_case> all = buildPageCases(), cases;
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (all[i].name.compare(0, filter.size(), filter) == 0) cases.push_back(all[i]);
+    }
+    std::string mkdir = "mkdir -p '" + opt.dir + "' '" + opt.dump + "'";
+    if (system(mkdir.c_str()) != 0) {
+        fprintf(stderr, "could not create %s or %s\n", opt.dir.c_str(), opt.dump.c_str());
+        return 1;
+    }
+
+    double start = nowSeconds();
+    std::vector<case_result> results(cases.size());
+    std::atomic<int> next(0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(std::thread(worker, &cases, &results, &next, &opt));
+    }
+    for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+    double elapsed = nowSeconds() - start;
+
+    int failed = 0;
+    for (size_t i = 0; i < cases.size(); ++i) {
+        const case_result& r = results[i];
+        if (opt.update) {
+            if (!r.written) {
+                printf("FAIL %s: could not write golden image\n", cases[i].name.c_str());
+                ++failed;
+            }
+            continue;
+        }
+        if (r.missing) {
+            printf("FAIL %s: no golden image (run with --update 1 to create it)\n", cases[i].name.c_str());
+            ++failed;
+            continue;
+        }
+        if (!r.mismatched) continue;
+        ++failed;
+        printf("FAIL %s: %d pixels differ in (%d,%d)-(%d,%d)\n", cases[i].name.c_str(), r.mismatched,
+               r.bbox[0], r.bbox[1], r.bbox[2], r.bbox[3]);
+        printf("     tiles:");
+        for (int ty = 0; ty < TILES_Y; ++ty) {
+            for (int tx = 0; tx < TILES_X; ++tx) {
+                if (r.tiles[ty][tx]) printf(" (%d,%d):%d", tx * TILE_SIZE, ty * TILE_SIZE, r.tiles[ty][tx]);
+            }
+        }
+        printf("\n     see %s/%s.actual.ppm and .diff.ppm\n", opt.dump.c_str(), cases[i].name.c_str());
+    }
+
+    printf("%s %d cases on %d threads in %.3f s, %d failed\n", opt.update ? "wrote" : "checked",
+           (int) cases.size(), (int) workers.size(), elapsed, failed);
+    return failed ? 1 : 0;
+}
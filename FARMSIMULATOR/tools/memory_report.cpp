@@ -0,0 +1,123 @@
+#include "Harness.h"
+
+#include <new>
+
+/*
+UI memory report
+Created 10/19/2026
+
+Builds every page of a fresh session one at a time and reports how many
+elements each one has and how many heap bytes building it took (counted by
+replacing operator new for this tool, so it includes child lists, click
+handlers and value functions, but not the few strings that get malloc'd),
+along with the size of each element class. Bytes are reported both as
+requested and as glibc malloc would round them up (8 bytes of header, 16
+byte granularity, 32 bytes at least), since small allocations are where
+that overhead adds up.
+
+usage: memory_report
+*/
+
+static size_t heapBytes = 0;
+static size_t heapChunkBytes = 0;
+static size_t heapAllocations = 0;
+
+// GCC inlines these into every new/delete pair and then warns that free is
+// called on memory from operator new, which is exactly the point here
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void* operator new(size_t size) {
+    heapBytes += size;
+    size_t chunk = (size + 8 + 15) & ~(size_t) 15;
+    heapChunkBytes += chunk < 32 ? 32 : chunk;
+    ++heapAllocations;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+#pragma GCC diagnostic pop
+
+struct page_memory_raw {
+    const char* name;
+    int elements;
+    size_t bytes;
+    size_t chunkBytes;
+    size_t allocations;
+} typedef page_memory;
+
+// elements in the subtree under root, including root
+static int countElements(UIElement* root) {
+    std::vector<DrawNode> list;
+    root->collectDrawList(list);
+    // static page items get nodes too, but they aren't elements
+    int count = 0;
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (!list[i].item) ++count;
+    }
+    return count;
+}
+
+// build one page and record what it cost
+static page_memory measurePage(const char* name, UIElement* (*build)(), int alreadyCounted = 0) {
+    size_t bytes = heapBytes, chunkBytes = heapChunkBytes, allocations = heapAllocations;
+    UIElement* page = build();
+    page_memory m;
+    m.name = name;
+    m.bytes = heapBytes - bytes;
+    m.chunkBytes = heapChunkBytes - chunkBytes;
+    m.allocations = heapAllocations - allocations;
+    m.elements = countElements(page) - alreadyCounted;
+    return m;
+}
+
+int main() {
+    printf("%-16s %6s\n", "class", "bytes");
+    printf("%-16s %6d\n", "UIElement", (int) sizeof(UIElement));
+    printf("%-16s %6d\n", "RectangleElement", (int) sizeof(RectangleElement));
+    printf("%-16s %6d\n", "CircleElement", (int) sizeof(CircleElement));
+    printf("%-16s %6d\n", "StringElement", (int) sizeof(StringElement));
+    printf("%-16s %6d\n", "ValueElement", (int) sizeof(ValueElement));
+    printf("%-16s %6d\n", "StaticPage", (int) sizeof(StaticPage));
+    printf("\n");
+
+    initUI();
+    switchToPage(MainMenu);
+    playGame(0);
+    for (int i = 0; i < 10; ++i) G->event_occurred[i] = (i == 1 || i == 4);
+
+    // the game menu includes the top bar, which is counted on its own
+    int topBarElements = countElements(TopBar);
+    page_memory pages[] = {
+        measurePage("main menu", getMainMenu),
+        measurePage("credits", getCreditsPage),
+        measurePage("instructions", getInstructionsPage),
+        measurePage("statistics", getStatisticsPage),
+        measurePage("difficulty", getDifficultySelection),
+        measurePage("top bar", getTopBar),
+        measurePage("game menu", getGameMenu, topBarElements),
+        measurePage("home panel", getHomePanel),
+        measurePage("plots panel", getPlotsPanel),
+        measurePage("transition", getDayTransition),
+        measurePage("events", [] { return new UIElement(getEventsScreen()); }),
+        measurePage("game over", getGameOverScreen),
+    };
+
+    printf("%-14s %9s %12s %9s %9s %9s %9s\n", "", "", "", "requested", "", "malloc'd", "");
+    printf("%-14s %9s %12s %9s %9s %9s %9s\n", "page", "elements", "allocations",
+           "bytes", "per elem", "bytes", "per elem");
+    page_memory total = page_memory{"total", 0, 0, 0, 0};
+    for (const page_memory& m : pages) {
+        printf("%-14s %9d %12zu %9zu %9.1f %9zu %9.1f\n", m.name, m.elements, m.allocations,
+               m.bytes, m.elements ? (double) m.bytes / m.elements : 0.0,
+               m.chunkBytes, m.elements ? (double) m.chunkBytes / m.elements : 0.0);
+        total.elements += m.elements;
+        total.bytes += m.bytes;
+        total.chunkBytes += m.chunkBytes;
+        total.allocations += m.allocations;
+    }
+    printf("%-14s %9d %12zu %9zu %9.1f %9zu %9.1f\n", total.name, total.elements, total.allocations,
+           total.bytes, total.elements ? (double) total.bytes / total.elements : 0.0,
+           total.chunkBytes, total.elements ? (double) total.chunkBytes / total.elements : 0.0);
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "GameState.h"
+#include "StatsAggregator.h"
+#include "FEHRandom.h"
+#include "ResultsFile.h"
+#include "PerfCounters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/*
+Parallel game simulation
+Created 10/19/2026
+
+Plays whole games on several threads with GameState::fast_forward (harvest
+and replant every day, a different crop each game) until each game goes
+broke or hits the day limit. Every thread counts into its own StatsShard,
+and the main thread polls StatsAggregator::snapshot a few times a second to
+print live totals without ever stopping the simulation threads.
+
+Besides the totals, each shard keeps quantile sketches of the days each
+game lasted, its final coins and the profit made on its crop, and the
+medians and tails of those are printed at the end.
+
+Game i is seeded with --seed + i, so a game plays out the same however many
+threads there are. With --results, every game also becomes a row of a
+columnar results file (see ResultsFile.h), written by a background thread;
+build/results_query reads it back.
+
+usage: parallel_sim [--threads N] [--games N] [--max-days N]
+                    [--difficulty 0|1] [--seed N] [--quiet 1]
+                    [--results FILE]
+*/
+
+static const crop_type* crops[4] = {&carrot, &tomato, &corn, &lettuce};
+
+// The shard counters a results row is the per game change in
+static void shardCounters(const StatsShard* shard, int64_t* row) {
+    row[RESULTS_MONEY_EARNED] = shard->money_earned.load(std::memory_order_relaxed);
+    row[RESULTS_MONEY_LOST] = shard->money_lost.load(std::memory_order_relaxed);
+    for (int c = 1; c < NUMBER_OF_CROP_TYPES; c++) {
+        row[RESULTS_CROPS_PLANTED(c)] = shard->crops_planted[c].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < NUMBER_OF_EVENT_TYPES; i++) {
+        row[RESULTS_EVENTS(i)] = shard->events_fired[i].load(std::memory_order_relaxed);
+    }
+}
+
+// one simulation thread, plays games until the shared counter runs out
+static void simulate(StatsShard* shard, std::atomic<long long>* gamesLeft, int maxDays, int difficulty,
+                     unsigned int seed, ResultsWriter* results) {
+    results_chunk* chunk = results ? results->take_chunk() : nullptr;
+    int64_t before[RESULTS_COLUMNS], row[RESULTS_COLUMNS];
+    long long game;
+    while ((game = gamesLeft->fetch_sub(1)) > 0) {
+        RandSeed(seed + (unsigned int) game);
+        if (chunk) shardCounters(shard, before);
+        GameState g(difficulty);
+        g.shard = shard;
+        crop_type crop = *crops[game % 4];
+        g.fast_forward(maxDays, FF_HARVEST_AND_REPLANT, &crop);
+        shard->record_game(g.curr_day, g.coins);
+        if (!chunk) continue;
+
+        shardCounters(shard, row);
+        for (int c = RESULTS_MONEY_EARNED; c < RESULTS_COLUMNS; c++) row[c] -= before[c];
+        row[RESULTS_SEED] = seed + (unsigned int) game;
+        row[RESULTS_DIFFICULTY] = difficulty;
+        row[RESULTS_DAYS] = g.curr_day;
+        row[RESULTS_FINAL_COINS] = g.coins;
+        chunk->append(row);
+        if (chunk->full()) {
+            results->submit(chunk);
+            chunk = results->take_chunk();
+        }
+    }
+    if (chunk) results->submit(chunk);
+}
+
+static void printTotals(const stats_totals& t, double elapsed) {
+    printf("games: %lld  days: %lld  games/sec: %.0f  days/sec: %.0f  median days: %lld\n",
+           t.games, t.days_survived, t.games / elapsed, t.days_survived / elapsed,
+           t.sketches[SKETCH_DAYS_SURVIVED].quantile(0.5));
+    fflush(stdout);
+}
+
+static void printQuantiles(const char* name, const QuantileSketch& sketch) {
+    if (!sketch.total) return;
+    printf("%-15s %10lld %10lld %10lld\n", name, sketch.quantile(0.50), sketch.quantile(0.95),
+           sketch.quantile(0.99));
+}
+
+int main(int argc, char** argv) {
+    int threads = (int) std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    long long games = 1000000;
+    int maxDays = 365;
+    int difficulty = 0;
+    unsigned int seed = 1;
+    int quiet = 0;
+    const char* resultsPath = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--threads")) threads = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--games")) games = atoll(argv[i+1]);
+        else if (!strcmp(argv[i], "--max-days")) maxDays = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--difficulty")) difficulty = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--seed")) seed = (unsigned int) atol(argv[i+1]);
+        else if (!strcmp(argv[i], "--quiet")) quiet = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--results")) resultsPath = argv[i+1];
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (threads < 1) threads = 1;
+
+    ResultsWriter results;
+    if (resultsPath && !results.open(resultsPath)) {
+        fprintf(stderr, "can't write %s\n", resultsPath);
+        return 1;
+    }
+
+    StatsAggregator aggregator;
+    std::atomic<long long> gamesLeft(games);
+    std::vector<std::thread> workers;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads; i++) {
+        StatsShard* shard = aggregator.add_shard();
+        if (!shard) break;
+        workers.push_back(std::thread(simulate, shard, &gamesLeft, maxDays, difficulty, seed,
+                                      resultsPath ? &results : nullptr));
+    }
+
+    if (workers.empty()) {
+        fprintf(stderr, "couldn't start any simulation threads\n");
+        return 1;
+    }
+
+    // live dashboard (the totals are too big for the stack)
+    static stats_totals t;
+    while (true) {
+        aggregator.snapshot(t);
+        if (t.games >= games) break;
+        if (!quiet) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            printTotals(t, elapsed > 0 ? elapsed : 1e-9);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    if (resultsPath && !results.close()) {
+        fprintf(stderr, "writing %s failed\n", resultsPath);
+        return 1;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    aggregator.snapshot(t);
+    printf("threads:        %d\n", (int) workers.size());
+    printTotals(t, elapsed);
+    printf("%-15s %10s %10s %10s\n", "per game", "p50", "p95", "p99");
+    printQuantiles("days survived", t.sketches[SKETCH_DAYS_SURVIVED]);
+    printQuantiles("final coins", t.sketches[SKETCH_FINAL_COINS]);
+    const char* cropNames[NUMBER_OF_CROP_TYPES] = {"", "carrot profit", "tomato profit", "corn profit", "lettuce profit"};
+    for (int c = 1; c < NUMBER_OF_CROP_TYPES; c++) {
+        printQuantiles(cropNames[c], t.sketches[SKETCH_CROP_PROFIT(c)]);
+    }
+    printf("money earned:   %lld\n", t.money_earned);
+    printf("money lost:     %lld\n", t.money_lost);
+    printf("crops planted: ");
+    for (int i = 1; i < NUMBER_OF_CROP_TYPES; i++) printf(" %lld", t.crops_planted[i]);
+    printf("\nevents fired:  ");
+    for (int i = 0; i < NUMBER_OF_EVENT_TYPES; i++) printf(" %lld", t.events_fired[i]);
+    printf("\n");
+    PERF_REPORT(stdout);
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "Harness.h"
+#include "Pages.h"
+#include "DisplayList.h"
+
+/*
+Render benchmark
+Created 10/19/2026
+
+Draws every page in the Pages.h matrix three ways: the plain recursive
+render, the occlusion-culled renderVisible, and the batched DisplayList.
+For each page it logs the overdraw (pixels written per screen pixel), the
+number of color state changes sent to the LCD, and the time per frame
+(drawing plus LCD.Update). The frames from all three are compared so that a
+culling or batching bug shows up here as well as in the golden image check.
+
+usage: render_bench [--frames N] [--filter prefix]
+*/
+
+#define MODE_PLAIN 0
+#define MODE_CULLED 1
+#define MODE_BATCHED 2
+#define NUMBER_OF_MODES 3
+
+struct render_stats_raw {
+    unsigned long long pixels;
+    unsigned long long changes;
+    double seconds;
+} typedef render_stats;
+
+static thread_local DisplayList displayList;
+
+// draw the current page frames times, keep the counters of the last frame
+static render_stats measure(int mode, int frames) {
+    render_stats stats = render_stats{0, 0, 0};
+    double start = nowSeconds();
+    for (int frame = 0; frame < frames; ++frame) {
+        LCD.Clear();
+        LCD.ResetCounters();
+        if (mode == MODE_PLAIN) Screen->render();
+        else if (mode == MODE_CULLED) Screen->renderVisible();
+        else displayList.render(Screen);
+        // present too, a frame isn't on screen until then
+        LCD.Update();
+    }
+    stats.seconds = (nowSeconds() - start) / frames;
+    stats.pixels = LCD.PixelsWritten();
+    stats.changes = LCD.StateChanges();
+    return stats;
+}
+
+int main(int argc, char** argv) {
+    int frames = 200;
+    std::string filter;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--frames")) frames = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--filter")) filter = argv[i+1];
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (frames < 1) frames = 1;
+
+    const double screen = (double) (FEHLCD::Width * FEHLCD::Height);
+    const char* modeNames[NUMBER_OF_MODES] = {"plain", "culled", "batched"};
+    std::vector<page_case> cases = buildPageCases();
+    std::vector<unsigned int> plain(FEHLCD::Width * FEHLCD::Height);
+    render_stats totals[NUMBER_OF_MODES] = {};
+    int pages = 0, mismatched = 0;
+
+    printf("%-18s %27s %20s %27s\n", "", "overdraw", "state changes", "us per frame");
+    printf("%-18s %8s %8s %9s %6s %6s %6s %8s %8s %9s\n", "page",
+           "plain", "culled", "batched", "plain", "culled", "batch", "plain", "culled", "batched");
+    for (size_t i = 0; i < cases.size(); ++i) {
+        if (cases[i].name.compare(0, filter.size(), filter) != 0) continue;
+        setupPageCase(cases[i]);
+
+        render_stats s[NUMBER_OF_MODES];
+        bool same = true;
+        for (int mode = 0; mode < NUMBER_OF_MODES; ++mode) {
+            s[mode] = measure(mode, frames);
+            if (mode == MODE_PLAIN) memcpy(plain.data(), LCD.Pixels(), plain.size() * sizeof(unsigned int));
+            else if (memcmp(plain.data(), LCD.Pixels(), plain.size() * sizeof(unsigned int))) same = false;
+            totals[mode].pixels += s[mode].pixels;
+            totals[mode].changes += s[mode].changes;
+            totals[mode].seconds += s[mode].seconds;
+        }
+
+        printf("%-18s %8.2f %8.2f %9.2f %6llu %6llu %6llu %8.1f %8.1f %9.1f%s\n", cases[i].name.c_str(),
+               s[0].pixels / screen, s[1].pixels / screen, s[2].pixels / screen,
+               s[0].changes, s[1].changes, s[2].changes,
+               s[0].seconds * 1e6, s[1].seconds * 1e6, s[2].seconds * 1e6, same ? "" : "  FRAMES DIFFER");
+        ++pages;
+        if (!same) ++mismatched;
+    }
+
+    if (!pages) return 0;
+    printf("\npages: %d\n", pages);
+    for (int mode = 0; mode < NUMBER_OF_MODES; ++mode) {
+        printf("%-8s overdraw %.2f, %.1f state changes per frame, %.1f us per frame\n", modeNames[mode],
+               totals[mode].pixels / screen / pages, (double) totals[mode].changes / pages,
+               totals[mode].seconds * 1e6 / pages);
+    }
+    printf("mismatched pages: %d\n", mismatched);
+    PERF_REPORT(stdout);
+    return mismatched ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+#include "ResultsFile.h"
+#include "StatsAggregator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+Results file query
+Created 10/19/2026
+
+Reads a results file written by parallel_sim --results (see ResultsFile.h).
+
+On its own it prints a summary of every column (encoded size, min, max and
+mean) worked out from the footer alone, without decoding any data.
+
+--column NAME scans that one column and prints its 50th, 90th and 99th
+percentile, along with how long the scan took. Adding --at-least N instead
+counts the rows where the column is at least N: chunks whose footer min and
+max already decide it are counted or skipped without being decoded.
+
+usage: results_query FILE [--column NAME] [--at-least N]
+*/
+
+static double seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: results_query FILE [--column NAME] [--at-least N]\n");
+        return 1;
+    }
+    const char* path = argv[1];
+    const char* columnName = nullptr;
+    bool filter = false;
+    long long atLeast = 0;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--column")) columnName = argv[i+1];
+        else if (!strcmp(argv[i], "--at-least")) {
+            filter = true;
+            atLeast = atoll(argv[i+1]);
+        }
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    ResultsReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "can't read %s as a results file\n", path);
+        return 1;
+    }
+    long long rows = reader.rows();
+    printf("rows: %lld  chunks: %d  file: %.1f MB (%.1f bytes per row)\n", rows, reader.chunks(),
+           reader.size / 1e6, rows ? (double) reader.size / rows : 0.0);
+
+    if (!columnName) {
+        printf("%-18s %10s %9s %12s %12s %12s\n", "column", "bytes", "per row", "min", "max", "mean");
+        for (int c = 0; c < RESULTS_COLUMNS; c++) {
+            long long bytes = 0, sum = 0, min = 0, max = 0;
+            for (int chunk = 0; chunk < reader.chunks(); chunk++) {
+                const results_column_meta& m = reader.meta(chunk, c);
+                if (chunk == 0 || m.min < min) min = m.min;
+                if (chunk == 0 || m.max > max) max = m.max;
+                bytes += m.bytes;
+                sum += m.sum;
+            }
+            printf("%-18s %10lld %9.2f %12lld %12lld %12.1f\n", reader.names[c], bytes,
+                   rows ? (double) bytes / rows : 0.0, min, max, rows ? (double) sum / rows : 0.0);
+        }
+        return 0;
+    }
+
+    int column = reader.column(columnName);
+    if (column < 0) {
+        fprintf(stderr, "no column %s\n", columnName);
+        return 1;
+    }
+    double start = seconds();
+    if (filter) {
+        long long count = 0;
+        int decoded = 0, skipped = 0;
+        for (int chunk = 0; chunk < reader.chunks(); chunk++) {
+            const results_column_meta& m = reader.meta(chunk, column);
+            if (m.max < atLeast) {
+                skipped++;
+            } else if (m.min >= atLeast) {
+                count += (long long) reader.metas[chunk].rows;
+                skipped++;
+            } else {
+                decoded++;
+                bool ok = reader.scan_chunk(chunk, column, [&](const int64_t* values, int n) {
+                    for (int i = 0; i < n; i++) count += values[i] >= atLeast;
+                });
+                if (!ok) {
+                    fprintf(stderr, "%s is corrupt: column %s of chunk %d ends early\n", path, columnName, chunk);
+                    return 1;
+                }
+            }
+        }
+        double elapsed = seconds() - start;
+        printf("%s >= %lld: %lld rows (%.2f%%)\n", columnName, atLeast, count,
+               rows ? 100.0 * count / rows : 0.0);
+        printf("chunks decoded: %d  decided from the footer: %d  time: %.3f s\n", decoded, skipped, elapsed);
+        return 0;
+    }
+
+    QuantileSketch sketch;
+    memset(&sketch, 0, sizeof(sketch));
+    bool ok = reader.scan(column, [&](const int64_t* values, int n) {
+        for (int i = 0; i < n; i++) sketch.add(values[i]);
+    });
+    if (!ok) {
+        fprintf(stderr, "%s is corrupt: column %s ends early\n", path, columnName);
+        return 1;
+    }
+    double elapsed = seconds() - start;
+    printf("%s  p50: %lld  p90: %lld  p99: %lld\n", columnName, sketch.quantile(0.50),
+           sketch.quantile(0.90), sketch.quantile(0.99));
+    printf("scanned in %.3f s (%.0f million rows/sec)\n", elapsed, elapsed > 0 ? rows / elapsed / 1e6 : 0.0);
+    return 0;
+}
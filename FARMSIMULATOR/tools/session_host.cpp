@@ -0,0 +1,670 @@
+#include "Harness.h"
+#include "FEHRandom.h"
+#include "DisplayList.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+Multi-session host
+Created 10/19/2026
+
+Hosts many independent headless games in one process. Every game is a
+UISession (see the bottom of UIElements.h) with its own GameState and element
+tree; a fixed pool of worker threads loads a session into its thread's UI
+globals, handles one command, and saves it back.
+
+Clients talk to the host over a local Unix domain socket with one command per
+line and one response line per command. Commands on a connection are handled
+in order, one at a time; use more connections for more concurrency.
+
+    NEW                 -> OK <id>
+    TAP <id> <x> <y>    -> OK <state>     tap at (x, y), then same as STATE
+    STATE <id>          -> OK page=<page> panel=<panel> day=<n> coins=<n> plots=<12 chars>
+    BUTTONS <id>        -> OK <label>@<x>,<y>;...     current click targets
+    RENDER <id>         -> OK <n> <y0>-<y1>=<pixels>,...   rows changed since last RENDER
+    CLOSE <id>          -> OK                         frees the session
+    anything else       -> ERR <reason>
+
+In the plots string '.' is an empty plot and a digit is the days left until
+the crop is ready.
+
+RENDER sends n, the number of rows that changed, then each run of changed
+rows with its pixels, row by row, run-length encoded as <count>x<rrggbb>
+pieces joined by '.' (a run of pixels can carry on into the next row). The
+first RENDER of a session sends every row.
+
+CLOSE frees the session's game state and element tree on the worker that
+handles it. Its id is handed out again by a later NEW, so clients shouldn't
+use an id after closing it.
+
+usage:
+    session_host serve <socket> [--threads N]
+    session_host load <socket> [--connections N] [--sessions N] [--commands N]
+    session_host bench [--threads N] [--connections N] [--sessions N] [--commands N]
+
+load drives a running host with random taps from several connections,
+rendering now and then and replacing a session every 64 commands, and
+reports throughput and latency percentiles; bench does the same against a
+host started in the same process and also reports memory per session and
+sessions per worker thread.
+*/
+
+// one hosted game
+struct HostedSession {
+    std::mutex lock;
+    UISession* ui;
+    unsigned int rowHash[FEHLCD::Height];
+    bool open;
+};
+
+// one client connection
+struct Connection {
+    int fd;
+    std::string input;
+    std::atomic<bool> busy;
+    bool hungUp;
+};
+
+struct Task {
+    Connection* conn;
+    std::string line;
+};
+
+// each worker renders into its own LCD with its own draw command buffers
+static thread_local DisplayList displayList;
+
+class SessionHost {
+    public:
+    explicit SessionHost(int threads) : numThreads(threads) {}
+
+    bool start(const char* path);
+    void stop();
+    long sessionCount();
+
+    private:
+    void ioLoop();
+    void workerLoop();
+    void dispatchReady();
+    void wake();
+    std::string execute(const std::string& line);
+    std::string summary();
+    HostedSession* find(long id);
+
+    int numThreads;
+    int listenFd = -1;
+    int wakePipe[2];
+    std::atomic<bool> running;
+    std::thread ioThread;
+    std::vector<std::thread> workers;
+    std::vector<Connection*> connections;
+
+    std::mutex queueLock;
+    std::condition_variable queueReady;
+    std::deque<Task> tasks;
+
+    std::mutex tableLock;
+    std::vector<HostedSession*> sessions;
+    // ids of closed sessions, reused before the table grows
+    std::vector<long> freeIds;
+};
+
+bool SessionHost::start(const char* path) {
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+    if (bind(listenFd, (sockaddr*) &addr, sizeof(addr)) < 0 || listen(listenFd, 128) < 0) {
+        close(listenFd);
+        return false;
+    }
+    fcntl(listenFd, F_SETFL, O_NONBLOCK);
+    if (pipe(wakePipe) < 0) return false;
+    fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+
+    running = true;
+    for (int i = 0; i < numThreads; ++i) {
+        workers.push_back(std::thread(&SessionHost::workerLoop, this));
+    }
+    ioThread = std::thread(&SessionHost::ioLoop, this);
+    return true;
+}
+
+void SessionHost::stop() {
+    running = false;
+    wake();
+    queueReady.notify_all();
+    ioThread.join();
+    for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+    for (size_t i = 0; i < connections.size(); ++i) {
+        close(connections[i]->fd);
+        delete connections[i];
+    }
+    close(listenFd);
+    close(wakePipe[0]);
+    close(wakePipe[1]);
+}
+
+long SessionHost::sessionCount() {
+    std::lock_guard<std::mutex> guard(tableLock);
+    return (long) (sessions.size() - freeIds.size());
+}
+
+void SessionHost::wake() {
+    char byte = 1;
+    if (write(wakePipe[1], &byte, 1) < 0) {
+        // pipe already full means a wakeup is pending anyway
+    }
+}
+
+// hand the next complete line of every idle connection to the workers
+void SessionHost::dispatchReady() {
+    for (size_t i = 0; i < connections.size(); ++i) {
+        Connection* c = connections[i];
+        if (c->busy) continue;
+        size_t newline = c->input.find('\n');
+        if (newline == std::string::npos) continue;
+        Task task;
+        task.conn = c;
+        task.line = c->input.substr(0, newline);
+        c->input.erase(0, newline + 1);
+        c->busy = true;
+        {
+            std::lock_guard<std::mutex> guard(queueLock);
+            tasks.push_back(task);
+        }
+        queueReady.notify_one();
+    }
+}
+
+void SessionHost::ioLoop() {
+    std::vector<pollfd> fds;
+    char buffer[4096];
+    while (running) {
+        fds.clear();
+        pollfd p;
+        p.fd = listenFd; p.events = POLLIN; p.revents = 0;
+        fds.push_back(p);
+        p.fd = wakePipe[0];
+        fds.push_back(p);
+        for (size_t i = 0; i < connections.size(); ++i) {
+            p.fd = connections[i]->fd;
+            fds.push_back(p);
+        }
+        if (poll(fds.data(), fds.size(), 100) < 0 && errno != EINTR) break;
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                Connection* c = new Connection;
+                c->fd = fd;
+                c->busy = false;
+                c->hungUp = false;
+                connections.push_back(c);
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            while (read(wakePipe[0], buffer, sizeof(buffer)) > 0) {}
+        }
+        for (size_t i = 2; i < fds.size(); ++i) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            Connection* c = connections[i - 2];
+            ssize_t n;
+            while ((n = read(c->fd, buffer, sizeof(buffer))) > 0) {
+                c->input.append(buffer, (size_t) n);
+            }
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                c->hungUp = true;
+            }
+        }
+        dispatchReady();
+
+        // drop hung up connections once their last command is done
+        for (size_t i = 0; i < connections.size();) {
+            Connection* c = connections[i];
+            if (c->hungUp && !c->busy) {
+                close(c->fd);
+                delete c;
+                connections.erase(connections.begin() + i);
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+}
+
+void SessionHost::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> guard(queueLock);
+            while (running && tasks.empty()) queueReady.wait(guard);
+            if (!running) return;
+            task = tasks.front();
+            tasks.pop_front();
+        }
+        std::string response = execute(task.line);
+        response += '\n';
+
+        // the socket is non-blocking, wait for room if the client is slow
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t n = write(task.conn->fd, response.data() + sent, response.size() - sent);
+            if (n > 0) {
+                sent += (size_t) n;
+            }
+            else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                pollfd p;
+                p.fd = task.conn->fd; p.events = POLLOUT; p.revents = 0;
+                poll(&p, 1, 100);
+            }
+            else {
+                break;
+            }
+        }
+        task.conn->busy = false;
+        wake();
+    }
+}
+
+HostedSession* SessionHost::find(long id) {
+    std::lock_guard<std::mutex> guard(tableLock);
+    if (id < 0 || id >= (long) sessions.size()) return nullptr;
+    return sessions[id];
+}
+
+// pixels run-length encoded for RENDER, <count>x<rrggbb> joined by '.'
+static void appendPixels(std::string& out, const unsigned int* pixels, int count) {
+    char piece[24];
+    int i = 0;
+    while (i < count) {
+        int run = 1;
+        while (i + run < count && pixels[i + run] == pixels[i]) ++run;
+        snprintf(piece, sizeof(piece), "%s%dx%06x", i ? "." : "", run, pixels[i] & 0xFFFFFF);
+        out += piece;
+        i += run;
+    }
+}
+
+// state of the session loaded on this thread
+std::string SessionHost::summary() {
+    const char* page = "other";
+    if (CurrentPage == MainMenu) page = "menu";
+    else if (CurrentPage == CreditsPage) page = "credits";
+    else if (CurrentPage == InstructionsPage) page = "instructions";
+    else if (CurrentPage == DifficultySelection) page = "difficulty";
+    else if (CurrentPage == GameMenu) page = "game";
+    else if (CurrentPage == DayTransitionScreen) page = "transition";
+    else if (CurrentPage == EventsScreen) page = "events";
+    else if (CurrentPage == GameOverScreen) page = "gameover";
+    const char* panel = CurrentGamePanel && CurrentGamePanel == PlotsPanel ? "plots" : "home";
+
+    char plots[NUMBER_OF_PLOTS + 1];
+    for (int i = 0; i < NUMBER_OF_PLOTS; ++i) {
+        int left = G->days_left(i);
+        plots[i] = G->plots[i].active ? (char) ('0' + (left > 9 ? 9 : left)) : '.';
+    }
+    plots[NUMBER_OF_PLOTS] = 0;
+
+    char out[160];
+    snprintf(out, sizeof(out), "OK page=%s panel=%s day=%d coins=%d plots=%s",
+             page, panel, G->curr_day, G->coins, plots);
+    return out;
+}
+
+std::string SessionHost::execute(const std::string& line) {
+    char verb[16];
+    long id = -1;
+    int x = 0, y = 0;
+    int fields = sscanf(line.c_str(), "%15s %ld %d %d", verb, &id, &x, &y);
+    if (fields < 1) return "ERR empty command";
+
+    if (!strcmp(verb, "NEW")) {
+        HostedSession* hs;
+        long newId;
+        {
+            std::lock_guard<std::mutex> guard(tableLock);
+            if (!freeIds.empty()) {
+                newId = freeIds.back();
+                freeIds.pop_back();
+                hs = sessions[newId];
+            }
+            else {
+                hs = new HostedSession;
+                hs->open = false;
+                newId = (long) sessions.size();
+                sessions.push_back(hs);
+            }
+        }
+        // still closed until it's filled in, so commands for the old
+        // session with this id get an error
+        std::lock_guard<std::mutex> guard(hs->lock);
+        hs->ui = newSession();
+        memset(hs->rowHash, 0, sizeof(hs->rowHash));
+        hs->open = true;
+        return "OK " + std::to_string(newId);
+    }
+
+    HostedSession* hs = find(id);
+    if (fields < 2 || !hs) return "ERR no such session";
+    std::lock_guard<std::mutex> guard(hs->lock);
+    if (!hs->open) return "ERR session closed";
+
+    if (!strcmp(verb, "CLOSE")) {
+        deleteSession(hs->ui);
+        hs->ui = nullptr;
+        hs->open = false;
+        std::lock_guard<std::mutex> tableGuard(tableLock);
+        freeIds.push_back(id);
+        return "OK";
+    }
+
+    std::string response;
+    loadSession(hs->ui);
+    if (!strcmp(verb, "TAP")) {
+        if (fields < 4) {
+            response = "ERR usage: TAP <id> <x> <y>";
+        }
+        else {
+            Screen->handleClick(x, y);
+            UIElement::reclaim(UIElement::ReclaimSlice);
+            response = summary();
+        }
+    }
+    else if (!strcmp(verb, "STATE")) {
+        response = summary();
+    }
+    else if (!strcmp(verb, "BUTTONS")) {
+        std::vector<ClickTarget> targets;
+        Screen->getClickTargets(targets);
+        response = "OK ";
+        char entry[96];
+        for (size_t i = 0; i < targets.size(); ++i) {
+            snprintf(entry, sizeof(entry), "%s%s@%d,%d", i ? ";" : "",
+                     targets[i].label ? targets[i].label : "-", targets[i].x, targets[i].y);
+            response += entry;
+        }
+    }
+    else if (!strcmp(verb, "RENDER")) {
+        // render into this worker's framebuffer and send the rows that
+        // changed compared to the hashes kept from the session's previous
+        // render
+        LCD.Clear();
+        displayList.render(Screen);
+        const unsigned int* pixels = LCD.Pixels();
+        std::string ranges;
+        int changed = 0, runStart = -1;
+        for (int row = 0; row <= FEHLCD::Height; ++row) {
+            bool differs = false;
+            if (row < FEHLCD::Height) {
+                unsigned int h = 2166136261u;
+                for (int col = 0; col < FEHLCD::Width; ++col) {
+                    h = (h ^ pixels[row * FEHLCD::Width + col]) * 16777619u;
+                }
+                differs = h != hs->rowHash[row];
+                hs->rowHash[row] = h;
+            }
+            if (differs) {
+                ++changed;
+                if (runStart < 0) runStart = row;
+            }
+            else if (runStart >= 0) {
+                if (!ranges.empty()) ranges += ',';
+                ranges += std::to_string(runStart) + "-" + std::to_string(row - 1) + "=";
+                appendPixels(ranges, pixels + runStart * FEHLCD::Width, (row - runStart) * FEHLCD::Width);
+                runStart = -1;
+            }
+        }
+        response = "OK " + std::to_string(changed) + (ranges.empty() ? "" : " " + ranges);
+    }
+    else {
+        response = "ERR unknown command";
+    }
+    saveSession(hs->ui);
+    return response;
+}
+
+/*
+Load generator
+*/
+static int connectTo(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, (sockaddr*) &addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// blocking request/response over a client connection
+struct Client {
+    int fd;
+    std::string pending;
+
+    bool request(const std::string& line, std::string* response) {
+        std::string out = line + "\n";
+        size_t sent = 0;
+        while (sent < out.size()) {
+            ssize_t n = write(fd, out.data() + sent, out.size() - sent);
+            if (n <= 0) return false;
+            sent += (size_t) n;
+        }
+        char buffer[4096];
+        size_t newline;
+        while ((newline = pending.find('\n')) == std::string::npos) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) return false;
+            pending.append(buffer, (size_t) n);
+        }
+        *response = pending.substr(0, newline);
+        pending.erase(0, newline + 1);
+        return true;
+    }
+};
+
+struct LoadResult {
+    long commands = 0;
+    long errors = 0;
+    std::vector<double> latencies;
+};
+
+// one connection: open some sessions, then tap random buttons on them
+static void loadWorker(const char* path, int sessionsPerConn, int commands, unsigned int seed, LoadResult* result) {
+    Client client;
+    client.fd = connectTo(path);
+    if (client.fd < 0) {
+        result->errors++;
+        return;
+    }
+    std::mt19937 rng(seed);
+    std::vector<long> ids;
+    std::string response;
+
+    // time every request, including session creation
+    auto timed = [&](const std::string& line) {
+        double start = nowSeconds();
+        bool ok = client.request(line, &response);
+        result->latencies.push_back(nowSeconds() - start);
+        result->commands++;
+        if (!ok || response.compare(0, 2, "OK")) result->errors++;
+        return ok;
+    };
+
+    for (int i = 0; i < sessionsPerConn; ++i) {
+        if (!timed("NEW")) break;
+        ids.push_back(atol(response.c_str() + 3));
+    }
+    for (int i = 0; i < commands && !ids.empty(); ++i) {
+        long id = ids[rng() % ids.size()];
+        std::string idStr = std::to_string(id);
+        if (i % 64 == 63) {
+            // swap the session for a new one now and then
+            if (!timed("CLOSE " + idStr) || !timed("NEW")) break;
+            for (size_t k = 0; k < ids.size(); ++k) {
+                if (ids[k] == id) ids[k] = atol(response.c_str() + 3);
+            }
+            continue;
+        }
+        if (i % 8 == 7) {
+            if (!timed("RENDER " + idStr)) break;
+            continue;
+        }
+        if (!timed("BUTTONS " + idStr)) break;
+        // pick a random "label@x,y" entry
+        std::vector<std::string> entries;
+        size_t pos = 3;
+        while (pos < response.size()) {
+            size_t next = response.find(';', pos);
+            if (next == std::string::npos) next = response.size();
+            entries.push_back(response.substr(pos, next - pos));
+            pos = next + 1;
+        }
+        if (entries.empty()) continue;
+        const std::string& entry = entries[rng() % entries.size()];
+        int x = 0, y = 0;
+        size_t at = entry.rfind('@');
+        if (at == std::string::npos || sscanf(entry.c_str() + at + 1, "%d,%d", &x, &y) != 2) continue;
+        if (!timed("TAP " + idStr + " " + std::to_string(x) + " " + std::to_string(y))) break;
+    }
+    close(client.fd);
+}
+
+static double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = (size_t) (p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+static int runLoad(const char* path, int connections, int sessionsPerConn, int commands, double* elapsedOut) {
+    std::vector<LoadResult> results(connections);
+    std::vector<std::thread> threads;
+    double start = nowSeconds();
+    for (int i = 0; i < connections; ++i) {
+        threads.push_back(std::thread(loadWorker, path, sessionsPerConn, commands, 1000u + i, &results[i]));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+    double elapsed = nowSeconds() - start;
+
+    std::vector<double> all;
+    long total = 0, errors = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        all.insert(all.end(), results[i].latencies.begin(), results[i].latencies.end());
+        total += results[i].commands;
+        errors += results[i].errors;
+    }
+    std::sort(all.begin(), all.end());
+
+    printf("connections:     %d\n", connections);
+    printf("sessions:        %d\n", connections * sessionsPerConn);
+    printf("commands:        %ld (%ld errors)\n", total, errors);
+    printf("elapsed:         %.3f s\n", elapsed);
+    printf("commands/sec:    %.0f\n", total / elapsed);
+    printf("latency p50:     %.1f us\n", percentile(all, 0.50) * 1e6);
+    printf("latency p99:     %.1f us\n", percentile(all, 0.99) * 1e6);
+    printf("latency max:     %.1f us\n", all.empty() ? 0.0 : all.back() * 1e6);
+    if (elapsedOut) *elapsedOut = elapsed;
+    return errors ? 1 : 0;
+}
+
+static void usage() {
+    fprintf(stderr,
+        "usage: session_host serve <socket> [--threads N]\n"
+        "       session_host load <socket> [--connections N] [--sessions N] [--commands N]\n"
+        "       session_host bench [--threads N] [--connections N] [--sessions N] [--commands N]\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    const char* mode = argv[1];
+    const char* path = nullptr;
+    int first = 2;
+    if (strcmp(mode, "bench")) {
+        if (argc < 3) {
+            usage();
+            return 1;
+        }
+        path = argv[2];
+        first = 3;
+    }
+
+    int threads = (int) std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    int connections = 16;
+    int sessionsPerConn = 64;
+    int commands = 2000;
+    for (int i = first; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--threads")) threads = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--connections")) connections = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--sessions")) sessionsPerConn = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--commands")) commands = atoi(argv[i+1]);
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (!strcmp(mode, "serve")) {
+        SessionHost host(threads);
+        if (!host.start(path)) {
+            perror("session_host");
+            return 1;
+        }
+        printf("serving on %s with %d worker threads\n", path, threads);
+        fflush(stdout);
+        while (true) pause();
+    }
+    if (!strcmp(mode, "load")) {
+        return runLoad(path, connections, sessionsPerConn, commands, nullptr);
+    }
+    if (!strcmp(mode, "bench")) {
+        char socketPath[64];
+        snprintf(socketPath, sizeof(socketPath), "/tmp/session_host.%d.sock", (int) getpid());
+        long rssBefore = residentBytes();
+        SessionHost host(threads);
+        if (!host.start(socketPath)) {
+            perror("session_host");
+            return 1;
+        }
+        double elapsed = 0;
+        int status = runLoad(socketPath, connections, sessionsPerConn, commands, &elapsed);
+        long hosted = host.sessionCount();
+        long rssAfter = residentBytes();
+        host.stop();
+        unlink(socketPath);
+
+        printf("worker threads:  %d\n", threads);
+        printf("sessions/thread: %.0f\n", (double) hosted / threads);
+        printf("rss growth:      %ld KiB (%.1f KiB/session)\n", (rssAfter - rssBefore) / 1024,
+               hosted ? (rssAfter - rssBefore) / 1024.0 / hosted : 0.0);
+        return status;
+    }
+    usage();
+    return 1;
+}
@@ -0,0 +1,182 @@
+#include "Harness.h"
+#include "DisplayList.h"
+#include "FEHRandom.h"
+
+#include <algorithm>
+
+/*
+Soak test
+Created 10/19/2026
+
+Runs the game the way a kiosk would for a very long time: the farmer agent
+plays game after game (end day -> transition -> news -> harvest -> plant),
+and between games opens the statistics page and goes back to the main menu.
+Every tap is followed by a reclaim slice and a full render and present, like
+main.cpp, and the time for each of those taps (the agent finding its target,
+handling the tap and drawing the frame) is recorded.
+
+Every --sample days, one row goes to the CSV file: days played, taps, resident
+memory, live elements, elements waiting to be freed, and the 50th, 90th and
+99th percentile and worst tap time in the sample.
+
+At the end, the first tenth of the samples is skipped as warmup, and the
+median of the first and last thirds of the rest are compared for each
+column. Anything that went up by more than its tolerance is reported as a
+trend and the exit status is 1, so a leak or a slowdown fails the run.
+
+usage: soak [--days N] [--sample N] [--game-days N] [--seed N]
+            [--csv FILE]
+*/
+
+struct soak_sample_raw {
+    long days;
+    long taps;
+    long rssKiB;
+    long liveElements;
+    int discarded;
+    double p50, p90, p99, worst; // microseconds
+} typedef soak_sample;
+
+// value at fraction q of the way through times, which gets reordered
+static double percentile(std::vector<double>& times, double q) {
+    size_t k = (size_t) (q * (times.size() - 1));
+    std::nth_element(times.begin(), times.begin() + k, times.end());
+    return times[k];
+}
+
+static double median(std::vector<double> values) {
+    return values.empty() ? 0 : percentile(values, 0.5);
+}
+
+// compares the first and last thirds of one column after warmup, and reports
+// it if it rose by more than both the absolute and relative tolerance
+static bool trend(const std::vector<soak_sample>& samples, const char* name,
+                  double (*column)(const soak_sample&), double absolute, double relative) {
+    size_t start = samples.size() / 10;
+    size_t third = (samples.size() - start) / 3;
+    if (third < 1) return false;
+    std::vector<double> first, last;
+    for (size_t i = 0; i < third; ++i) {
+        first.push_back(column(samples[start + i]));
+        last.push_back(column(samples[samples.size() - third + i]));
+    }
+    double before = median(first), after = median(last);
+    bool rising = after - before > absolute && after > before * (1 + relative);
+    printf("  %-16s %12.1f -> %12.1f  %s\n", name, before, after, rising ? "RISING" : "ok");
+    return rising;
+}
+
+int main(int argc, char** argv) {
+    long maxDays = 200000;
+    long sampleDays = 1000;
+    int gameDays = 100;
+    unsigned int seed = 1;
+    const char* csvPath = "soak.csv";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--days")) maxDays = atol(argv[i+1]);
+        else if (!strcmp(argv[i], "--sample")) sampleDays = atol(argv[i+1]);
+        else if (!strcmp(argv[i], "--game-days")) gameDays = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--seed")) seed = (unsigned int) atol(argv[i+1]);
+        else if (!strcmp(argv[i], "--csv")) csvPath = argv[i+1];
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (sampleDays < 1) sampleDays = 1;
+    FILE* csv = fopen(csvPath, "w");
+    if (!csv) {
+        fprintf(stderr, "can't write %s\n", csvPath);
+        return 1;
+    }
+    fprintf(csv, "days,taps,rss_kib,live_elements,discarded,p50_us,p90_us,p99_us,max_us\n");
+
+    // same setup as main.cpp
+    DisplayList displayList;
+    RandSeed(seed);
+    initUI();
+    switchToPage(MainMenu);
+    LCD.Clear();
+    displayList.render(Screen);
+    LCD.Update();
+
+    Tapper tapper;
+    FarmerAgent farmer;
+    std::vector<double> times;
+    std::vector<soak_sample> samples;
+    long days = 0, nextSample = sampleDays, games = 0;
+    double start = nowSeconds();
+
+    // one tap, timed through to the frame being presented
+    auto frame = [&](bool (*step)(Tapper&, FarmerAgent&)) {
+        double begin = nowSeconds();
+        bool more = step(tapper, farmer);
+        if (more) {
+            LCD.Clear();
+            displayList.render(Screen);
+            LCD.Update();
+            times.push_back((nowSeconds() - begin) * 1e6);
+        }
+        return more;
+    };
+
+    while (days < maxDays) {
+        // one game
+        farmer.reset((int) (games & 1), gameDays);
+        int day = 1;
+        while (frame([](Tapper& t, FarmerAgent& f) { return f.step(t); })) {
+            if (G->curr_day != day) {
+                days += G->curr_day > day ? G->curr_day - day : 0;
+                day = G->curr_day;
+            }
+        }
+        ++games;
+
+        // look at the statistics between games
+        frame([](Tapper& t, FarmerAgent&) {
+            t.scan();
+            return t.tap(findTarget(t.targets, "Statistics"));
+        });
+        frame([](Tapper& t, FarmerAgent&) {
+            t.scan();
+            return t.tap(findTarget(t.targets, "Return"));
+        });
+
+        if (days >= nextSample && !times.empty()) {
+            soak_sample s;
+            s.days = days;
+            s.taps = tapper.taps;
+            s.rssKiB = residentBytes() / 1024;
+            s.liveElements = UIElement::liveElements();
+            s.discarded = UIElement::discardedElements();
+            s.worst = *std::max_element(times.begin(), times.end());
+            s.p99 = percentile(times, 0.99);
+            s.p90 = percentile(times, 0.90);
+            s.p50 = percentile(times, 0.50);
+            fprintf(csv, "%ld,%ld,%ld,%ld,%d,%.2f,%.2f,%.2f,%.2f\n", s.days, s.taps, s.rssKiB,
+                    s.liveElements, s.discarded, s.p50, s.p90, s.p99, s.worst);
+            fflush(csv);
+            samples.push_back(s);
+            times.clear();
+            while (nextSample <= days) nextSample += sampleDays;
+        }
+    }
+    fclose(csv);
+
+    printf("days played:     %ld\n", days);
+    printf("games:           %ld\n", games);
+    printf("taps:            %ld\n", tapper.taps);
+    printf("elapsed:         %.1f s\n", nowSeconds() - start);
+    printf("samples:         %d (written to %s)\n", (int) samples.size(), csvPath);
+
+    // memory has to stay flat, frame times get more slack since this
+    // machine's timing is noisy
+    printf("\nfirst third vs last third (after warmup):\n");
+    bool rising = false;
+    rising |= trend(samples, "rss KiB", [](const soak_sample& s) { return (double) s.rssKiB; }, 256, 0.05);
+    rising |= trend(samples, "live elements", [](const soak_sample& s) { return (double) s.liveElements; }, 50, 0.05);
+    rising |= trend(samples, "p50 tap us", [](const soak_sample& s) { return s.p50; }, 5, 0.25);
+    rising |= trend(samples, "p99 tap us", [](const soak_sample& s) { return s.p99; }, 20, 0.5);
+    if (samples.size() < 4) printf("not enough samples to look for trends\n");
+    return rising ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+#include "Harness.h"
+#include "DisplayList.h"
+
+/*
+Startup benchmark
+Created 10/19/2026
+
+Times the same startup main.cpp goes through (initUI, switch to the main
+menu, draw and present the first frame, here through newSession so each run
+can be freed again with deleteSession) two ways: lazily, where only the
+main menu gets built before the first frame, and eagerly, where every page
+is built first with prewarmUI like the game used to do in initUI. Then
+times how long each page takes to build on its own, which is what the idle
+prewarm spends between the first frame and the first tap.
+
+usage: startup_bench [--runs N]
+*/
+
+static DisplayList displayList;
+// the globals from before any run, put back before deleteSession so they
+// don't end up pointing into the tree it frees
+static UISession noSession;
+
+// a fresh tree on the main menu, loaded into this thread's globals
+static UISession* startRun() {
+    UISession* session = newSession();
+    loadSession(session);
+    return session;
+}
+static void endRun(UISession* session) {
+    saveSession(session);
+    loadSession(&noSession);
+    deleteSession(session);
+}
+
+// seconds from a fresh session to the first frame being presented
+static double firstFrame(bool eager) {
+    double start = nowSeconds();
+    UISession* session = startRun();
+    if (eager) {
+        while (prewarmUI()) { }
+    }
+    LCD.Clear();
+    displayList.render(Screen);
+    LCD.Update();
+    double seconds = nowSeconds() - start;
+    endRun(session);
+    return seconds;
+}
+
+int main(int argc, char** argv) {
+    int runs = 200;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--runs")) runs = atoi(argv[i+1]);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (runs < 1) runs = 1;
+    saveSession(&noSession);
+
+    // first run of each warms up the allocator and the text cache
+    firstFrame(false);
+    firstFrame(true);
+    double lazy = 0, eager = 0;
+    for (int i = 0; i < runs; ++i) {
+        lazy += firstFrame(false);
+        eager += firstFrame(true);
+    }
+    printf("time to first frame, lazy:  %8.1f us\n", lazy / runs * 1e6);
+    printf("time to first frame, eager: %8.1f us\n", eager / runs * 1e6);
+
+    // build cost of every page, in prewarm order
+    const char* names[] = {"difficulty", "top bar", "game menu", "home panel", "plots panel",
+                           "transition", "game over", "instructions", "credits"};
+    const int count = sizeof(names) / sizeof(names[0]);
+    double seconds[count] = {};
+    for (int i = 0; i < runs; ++i) {
+        UISession* session = startRun();
+        for (int page = 0; page < count; ++page) {
+            double start = nowSeconds();
+            prewarmUI();
+            seconds[page] += nowSeconds() - start;
+        }
+        endRun(session);
+    }
+    printf("\nbuild time per page (idle prewarm):\n");
+    for (int page = 0; page < count; ++page) {
+        printf("  %-14s %8.1f us\n", names[page], seconds[page] / runs * 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,394 @@
+#include "GameState.h"
+#include "StatsAggregator.h"
+#include "FEHRandom.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Balance sweep
+Created 10/19/2026
+
+Tries every combination of a set of balance settings (see game_config in
+GameState.h) and ranks them by how players fare. Each --param gives one
+setting and the values to try, as lo:hi:step or a single value:
+
+  carrot.seed, carrot.sale, carrot.grow (and the same for tomato, corn
+  and lettuce), event.flood, event.tornado, event.fire, event.sunny_day,
+  event.thief, event.rain, event.bug, event.fertilizer, event.pandemic,
+  event.mystery, start_coins, chaos_start_coins, chaos_penalty_multiplier,
+  chaos_bonus_divisor
+
+Anything not swept keeps its usual value. Each combination plays --games
+games with GameState::fast_forward like parallel_sim does (harvest and
+replant every day, the crops taking turns from game to game), up to
+--max-days days each. Game i is seeded with --seed + i whatever the
+combination, so every combination faces the same weather and the
+differences between them come from the settings alone. Combinations are
+handed out to --threads threads one at a time.
+
+Every finished combination is appended to the --checkpoint file as soon as
+it's done. If the sweep is killed, running the same command again picks up
+where it left off; the file starts with a fingerprint of the sweep, and a
+different sweep refuses to use it. Delete the file to start over.
+
+At the end the combinations are ranked by the share of games that lasted
+to the day limit, then by median final coins, and the top --top are
+printed. --csv also writes every combination's results.
+
+usage: sweep --param NAME=LO:HI:STEP [--param ...] [--games N]
+             [--max-days N] [--difficulty 0|1] [--seed N] [--threads N]
+             [--checkpoint FILE] [--top N] [--csv FILE] [--quiet 1]
+*/
+
+// Most combinations one sweep will take on
+#define SWEEP_MAX_CONFIGS 10000000LL
+
+static const char* cropKeys[NUMBER_OF_CROP_TYPES] = {"", "carrot", "tomato", "corn", "lettuce"};
+static const char* eventKeys[10] = {"flood", "tornado", "fire", "sunny_day", "thief",
+                                    "rain", "bug", "fertilizer", "pandemic", "mystery"};
+
+struct sweep_param_raw {
+    std::string name;
+    int lo, hi, step;
+    int count;
+} typedef sweep_param;
+
+// How one combination did over all its games
+struct sweep_result_raw {
+    long long index;
+    int survived; // games that lasted to the day limit
+    long long days; // days played, all games
+    long long coins; // final coins, all games
+    long long p10, p50, p90; // final coins
+} typedef sweep_result;
+
+// The setting a parameter name refers to, or nullptr if there isn't one
+static int* configField(game_config& config, const std::string& name) {
+    if (name == "start_coins") return &config.start_coins;
+    if (name == "chaos_start_coins") return &config.chaos_start_coins;
+    if (name == "chaos_penalty_multiplier") return &config.chaos_penalty_multiplier;
+    if (name == "chaos_bonus_divisor") return &config.chaos_bonus_divisor;
+    for (int i = 0; i < 10; i++) {
+        if (name == std::string("event.") + eventKeys[i]) return &config.event_amounts[i];
+    }
+    for (int c = 1; c < NUMBER_OF_CROP_TYPES; c++) {
+        std::string crop = cropKeys[c];
+        if (name == crop + ".seed") return &config.crops[c].seed_price;
+        if (name == crop + ".sale") return &config.crops[c].sale_price;
+        if (name == crop + ".grow") return &config.crops[c].grow_time;
+    }
+    return nullptr;
+}
+
+// Parses NAME=LO:HI:STEP or NAME=VALUE, false if it's malformed
+static bool parseParam(const char* text, sweep_param& p) {
+    const char* eq = strchr(text, '=');
+    if (!eq) return false;
+    p.name = std::string(text, eq - text);
+    p.step = 1;
+    int fields = sscanf(eq + 1, "%d:%d:%d", &p.lo, &p.hi, &p.step);
+    if (fields < 1) return false;
+    if (fields == 1) p.hi = p.lo;
+    if (p.step < 1 || p.hi < p.lo) return false;
+    p.count = (p.hi - p.lo) / p.step + 1;
+    return true;
+}
+
+// Combination index to settings, the first parameter varying fastest
+static game_config decodeConfig(const std::vector<sweep_param>& params, long long index) {
+    game_config config = default_game_config;
+    for (size_t i = 0; i < params.size(); i++) {
+        *configField(config, params[i].name) = params[i].lo + (int) (index % params[i].count) * params[i].step;
+        index /= params[i].count;
+    }
+    return config;
+}
+
+// Plays every game of one combination
+static sweep_result evaluate(const game_config& config, long long index, int games, int maxDays,
+                             int difficulty, unsigned int seed) {
+    sweep_result r = sweep_result{index, 0, 0, 0, 0, 0, 0};
+    QuantileSketch coins;
+    memset(&coins, 0, sizeof(coins));
+    for (int game = 0; game < games; game++) {
+        RandSeed(seed + (unsigned int) game);
+        GameState g(difficulty, NUMBER_OF_PLOTS, config);
+        crop_type crop = config.crops[1 + game % 4];
+        ff_result ff = g.fast_forward(maxDays, FF_HARVEST_AND_REPLANT, &crop);
+        if (ff.survived && ff.days == maxDays) r.survived++;
+        r.days += ff.days;
+        r.coins += g.coins;
+        coins.add(g.coins);
+    }
+    r.p10 = coins.quantile(0.10);
+    r.p50 = coins.quantile(0.50);
+    r.p90 = coins.quantile(0.90);
+    return r;
+}
+
+// FNV-1a of everything that decides the results, so a checkpoint is only
+// resumed by the sweep that wrote it
+static unsigned long long fingerprint(const std::vector<sweep_param>& params, int games, int maxDays,
+                                      int difficulty, unsigned int seed) {
+    char buffer[64];
+    std::string spec;
+    for (size_t i = 0; i < params.size(); i++) {
+        snprintf(buffer, sizeof(buffer), "=%d:%d:%d;", params[i].lo, params[i].hi, params[i].step);
+        spec += params[i].name + buffer;
+    }
+    snprintf(buffer, sizeof(buffer), "%d,%d,%d,%u", games, maxDays, difficulty, seed);
+    spec += buffer;
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < spec.size(); i++) {
+        hash = (hash ^ (unsigned char) spec[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void writeResult(FILE* f, const sweep_result& r) {
+    fprintf(f, "%lld %d %lld %lld %lld %lld %lld\n", r.index, r.survived, r.days, r.coins, r.p10, r.p50, r.p90);
+}
+
+// Reads back the results in a checkpoint and rewrites it without anything
+// a kill left half written. Returns false if the file is from another
+// sweep or can't be rewritten.
+static bool loadCheckpoint(const char* path, unsigned long long print, long long total,
+                           std::vector<sweep_result>& results, std::vector<char>& done) {
+    FILE* f = fopen(path, "r");
+    if (!f) return true;
+    unsigned long long stored = 0;
+    char line[256];
+    if (!fgets(line, sizeof(line), f) || sscanf(line, "sweep-checkpoint %llx", &stored) != 1 || stored != print) {
+        fclose(f);
+        fprintf(stderr, "%s is from a different sweep, delete it or pass another --checkpoint\n", path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        sweep_result r;
+        // a line without its newline was cut off mid write
+        if (!strchr(line, '\n')) break;
+        if (sscanf(line, "%lld %d %lld %lld %lld %lld %lld", &r.index, &r.survived, &r.days, &r.coins,
+                   &r.p10, &r.p50, &r.p90) != 7) continue;
+        if (r.index < 0 || r.index >= total || done[r.index]) continue;
+        done[r.index] = 1;
+        results.push_back(r);
+    }
+    fclose(f);
+
+    std::string temp = std::string(path) + ".tmp";
+    FILE* out = fopen(temp.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "can't write %s\n", temp.c_str());
+        return false;
+    }
+    fprintf(out, "sweep-checkpoint %llx\n", print);
+    for (size_t i = 0; i < results.size(); i++) writeResult(out, results[i]);
+    if (fclose(out) != 0 || rename(temp.c_str(), path) != 0) {
+        fprintf(stderr, "can't replace %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+// Shared between the sweep threads
+struct sweep_work_raw {
+    const std::vector<sweep_param>* params;
+    const std::vector<long long>* pending;
+    std::atomic<size_t> next;
+    std::atomic<long long> finished;
+    std::mutex lock; // guards results and the checkpoint file
+    std::vector<sweep_result>* results;
+    FILE* checkpoint;
+    int games, maxDays, difficulty;
+    unsigned int seed;
+} typedef sweep_work;
+
+// one sweep thread, evaluates combinations until there are none left
+static void sweepThread(sweep_work* work) {
+    size_t i;
+    while ((i = work->next.fetch_add(1)) < work->pending->size()) {
+        long long index = (*work->pending)[i];
+        game_config config = decodeConfig(*work->params, index);
+        sweep_result r = evaluate(config, index, work->games, work->maxDays, work->difficulty, work->seed);
+        std::lock_guard<std::mutex> guard(work->lock);
+        work->results->push_back(r);
+        writeResult(work->checkpoint, r);
+        fflush(work->checkpoint);
+        work->finished++;
+    }
+}
+
+// most games to the day limit first, then the richest
+static bool betterResult(const sweep_result& a, const sweep_result& b) {
+    if (a.survived != b.survived) return a.survived > b.survived;
+    if (a.p50 != b.p50) return a.p50 > b.p50;
+    if (a.days != b.days) return a.days > b.days;
+    return a.index < b.index;
+}
+
+static std::string describe(const std::vector<sweep_param>& params, long long index) {
+    std::string text;
+    char buffer[64];
+    for (size_t i = 0; i < params.size(); i++) {
+        int value = params[i].lo + (int) (index % params[i].count) * params[i].step;
+        index /= params[i].count;
+        snprintf(buffer, sizeof(buffer), "%s=%d", params[i].name.c_str(), value);
+        text += (i ? " " : "") + std::string(buffer);
+    }
+    return text;
+}
+
+int main(int argc, char** argv) {
+    std::vector<sweep_param> params;
+    int games = 1000;
+    int maxDays = 365;
+    int difficulty = 0;
+    unsigned int seed = 1;
+    int threads = (int) std::thread::hardware_concurrency();
+    if (threads < 1) threads = 1;
+    const char* checkpointPath = "sweep.ckpt";
+    const char* csvPath = nullptr;
+    int top = 10;
+    int quiet = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--param")) {
+            sweep_param p;
+            game_config scratch = default_game_config;
+            if (!parseParam(argv[i+1], p) || !configField(scratch, p.name)) {
+                fprintf(stderr, "bad --param %s\n", argv[i+1]);
+                return 1;
+            }
+            // grow times and the chaos divisor can't be zero
+            bool positive = p.name == "chaos_bonus_divisor" ||
+                            (p.name.size() > 5 && p.name.compare(p.name.size() - 5, 5, ".grow") == 0);
+            if (positive && p.lo < 1) {
+                fprintf(stderr, "%s has to be at least 1\n", p.name.c_str());
+                return 1;
+            }
+            params.push_back(p);
+        }
+        else if (!strcmp(argv[i], "--games")) games = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--max-days")) maxDays = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--difficulty")) difficulty = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--seed")) seed = (unsigned int) atol(argv[i+1]);
+        else if (!strcmp(argv[i], "--threads")) threads = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--checkpoint")) checkpointPath = argv[i+1];
+        else if (!strcmp(argv[i], "--top")) top = atoi(argv[i+1]);
+        else if (!strcmp(argv[i], "--csv")) csvPath = argv[i+1];
+        else if (!strcmp(argv[i], "--quiet")) quiet = atoi(argv[i+1]);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (params.empty()) {
+        fprintf(stderr, "nothing to sweep, pass at least one --param\n");
+        return 1;
+    }
+    if (games < 1) games = 1;
+    if (threads < 1) threads = 1;
+
+    long long total = 1;
+    for (size_t i = 0; i < params.size(); i++) {
+        total *= params[i].count;
+        if (total > SWEEP_MAX_CONFIGS) {
+            fprintf(stderr, "more than %lld combinations, narrow the ranges\n", SWEEP_MAX_CONFIGS);
+            return 1;
+        }
+    }
+
+    // pick up whatever an earlier run of the same sweep finished
+    unsigned long long print = fingerprint(params, games, maxDays, difficulty, seed);
+    std::vector<sweep_result> results;
+    std::vector<char> done(total, 0);
+    if (!loadCheckpoint(checkpointPath, print, total, results, done)) return 1;
+    std::vector<long long> pending;
+    for (long long i = 0; i < total; i++) {
+        if (!done[i]) pending.push_back(i);
+    }
+    FILE* checkpoint = fopen(checkpointPath, results.empty() ? "w" : "a");
+    if (!checkpoint) {
+        fprintf(stderr, "can't write %s\n", checkpointPath);
+        return 1;
+    }
+    if (results.empty()) {
+        fprintf(checkpoint, "sweep-checkpoint %llx\n", print);
+        fflush(checkpoint);
+    }
+    printf("combinations: %lld (%lld already done), %d games each\n", total,
+           total - (long long) pending.size(), games);
+    fflush(stdout);
+
+    sweep_work work;
+    work.params = &params;
+    work.pending = &pending;
+    work.next = 0;
+    work.finished = 0;
+    work.results = &results;
+    work.checkpoint = checkpoint;
+    work.games = games;
+    work.maxDays = maxDays;
+    work.difficulty = difficulty;
+    work.seed = seed;
+
+    std::vector<std::thread> workers;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads; i++) workers.push_back(std::thread(sweepThread, &work));
+
+    // progress, with a rough estimate of the time left
+    while (work.finished < (long long) pending.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(quiet ? 50 : 1000));
+        if (quiet) continue;
+        long long finished = work.finished;
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double rate = finished / (elapsed > 0 ? elapsed : 1e-9);
+        printf("done: %lld/%lld  combinations/sec: %.1f  left: %.0f s\n", finished,
+               (long long) pending.size(), rate, rate > 0 ? (pending.size() - finished) / rate : 0.0);
+        fflush(stdout);
+    }
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    fclose(checkpoint);
+
+    std::sort(results.begin(), results.end(), betterResult);
+    if (csvPath) {
+        FILE* csv = fopen(csvPath, "w");
+        if (!csv) {
+            fprintf(stderr, "can't write %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csv, "rank,survival,mean_days,mean_coins,p10_coins,p50_coins,p90_coins");
+        for (size_t i = 0; i < params.size(); i++) fprintf(csv, ",%s", params[i].name.c_str());
+        fprintf(csv, "\n");
+        for (size_t r = 0; r < results.size(); r++) {
+            const sweep_result& s = results[r];
+            fprintf(csv, "%d,%.4f,%.1f,%.1f,%lld,%lld,%lld", (int) r + 1, (double) s.survived / games,
+                    (double) s.days / games, (double) s.coins / games, s.p10, s.p50, s.p90);
+            long long index = s.index;
+            for (size_t i = 0; i < params.size(); i++) {
+                fprintf(csv, ",%d", params[i].lo + (int) (index % params[i].count) * params[i].step);
+                index /= params[i].count;
+            }
+            fprintf(csv, "\n");
+        }
+        fclose(csv);
+    }
+
+    printf("%4s %9s %9s %9s %9s %9s  %s\n", "rank", "survival", "mean days", "p10 coins",
+           "p50 coins", "p90 coins", "settings");
+    for (int r = 0; r < top && r < (int) results.size(); r++) {
+        const sweep_result& s = results[r];
+        printf("%4d %8.1f%% %9.1f %9lld %9lld %9lld  %s\n", r + 1, 100.0 * s.survived / games,
+               (double) s.days / games, s.p10, s.p50, s.p90, describe(params, s.index).c_str());
+    }
+    return 0;
+}